@@ -2,20 +2,35 @@ set(PROJECT_HEADERS
     "src/XSEPlugin/Base/Configuration.h"
     "src/XSEPlugin/Base/Translation.h"
     "src/XSEPlugin/Core.h"
+    "src/XSEPlugin/Executor.h"
     "src/XSEPlugin/Function.h"
     "src/XSEPlugin/Hooks.h"
+    "src/XSEPlugin/ImGui/Impl/FontCache.h"
     "src/XSEPlugin/ImGui/Impl/Fonts.h"
+    "src/XSEPlugin/ImGui/Impl/FrameStats.h"
+    "src/XSEPlugin/ImGui/Impl/GlyphAtlas.h"
     "src/XSEPlugin/ImGui/Impl/Styles.h"
     "src/XSEPlugin/ImGui/Impl/Texts.h"
     "src/XSEPlugin/ImGui/Input.h"
     "src/XSEPlugin/ImGui/Menu.h"
     "src/XSEPlugin/ImGui/Renderer.h"
+    "src/XSEPlugin/Index.h"
     "src/XSEPlugin/InputManager.h"
+    "src/XSEPlugin/InputRecorder.h"
     "src/XSEPlugin/PCH.h"
+    "src/XSEPlugin/SymbolCache.h"
+    "src/XSEPlugin/Util/AllocStats.h"
+    "src/XSEPlugin/Util/Binary.h"
     "src/XSEPlugin/Util/CLib/Hook.h"
+    "src/XSEPlugin/Util/CLib/Hotkey.h"
     "src/XSEPlugin/Util/CLib/Key.h"
+    "src/XSEPlugin/Util/ChunkedBuffer.h"
+    "src/XSEPlugin/Util/ChunkedVector.h"
+    "src/XSEPlugin/Util/SearchIndex.h"
     "src/XSEPlugin/Util/Singleton.h"
     "src/XSEPlugin/Util/TOML.h"
+    "src/XSEPlugin/Util/ThreadPool.h"
+    "src/XSEPlugin/Util/UTF8.h"
     "src/XSEPlugin/Util/Win.h"
     "vendor/backends/imgui_impl_dx11.h"
     "vendor/backends/imgui_impl_win32.h"
@@ -2,16 +2,27 @@ set(PROJECT_SOURCES
     "src/XSEPlugin/Base/Configuration.cpp"
     "src/XSEPlugin/Base/Translation.cpp"
     "src/XSEPlugin/Core.cpp"
+    "src/XSEPlugin/Executor.cpp"
     "src/XSEPlugin/Function.cpp"
     "src/XSEPlugin/Hooks.cpp"
+    "src/XSEPlugin/ImGui/Impl/FontCache.cpp"
     "src/XSEPlugin/ImGui/Impl/Fonts.cpp"
+    "src/XSEPlugin/ImGui/Impl/FrameStats.cpp"
+    "src/XSEPlugin/ImGui/Impl/GlyphAtlas.cpp"
     "src/XSEPlugin/ImGui/Impl/Styles.cpp"
     "src/XSEPlugin/ImGui/Impl/Texts.cpp"
     "src/XSEPlugin/ImGui/Input.cpp"
     "src/XSEPlugin/ImGui/Menu.cpp"
     "src/XSEPlugin/ImGui/Renderer.cpp"
+    "src/XSEPlugin/Index.cpp"
     "src/XSEPlugin/InputManager.cpp"
+    "src/XSEPlugin/InputRecorder.cpp"
     "src/XSEPlugin/Main.cpp"
+    "src/XSEPlugin/SymbolCache.cpp"
+    "src/XSEPlugin/Util/AllocStats.cpp"
+    "src/XSEPlugin/Util/CLib/Hotkey.cpp"
+    "src/XSEPlugin/Util/SearchIndex.cpp"
+    "src/XSEPlugin/Util/ThreadPool.cpp"
     "src/XSEPlugin/Util/Win.cpp"
     "vendor/backends/imgui_impl_dx11.cpp"
     "vendor/backends/imgui_impl_win32.cpp"
@@ -6,7 +6,7 @@
 
 void Configuration::Init(bool a_abort)
 {
-    auto tmp = std::unique_ptr<Configuration, Deleter>{ new Configuration };
+    auto tmp = Make();
 
     if (std::filesystem::exists(_path)) {
         tmp->Load(&Configuration::LoadImpl, _path, a_abort);
@@ -29,7 +29,7 @@ void Configuration::Init(bool a_abort)
         tmp->Save(&Configuration::SaveImpl_Styles, _path_styles, a_abort);
     }
 
-    _singleton = std::move(tmp);
+    Publish(std::move(tmp));
 }
 
 void Configuration::Load(LoadImplFunc a_func, const std::filesystem::path& a_path, bool a_abort)
@@ -78,18 +78,38 @@ void Configuration::LoadImpl(const std::filesystem::path& a_path)
     }
 
     if (auto section = TOML::GetSection(data, "Controls"sv)) {
+        TOML::GetValue(section, "iDoubleTapTime"sv, controls.iDoubleTapTime);
+        TOML::GetValue(section, "iHoldTime"sv, controls.iHoldTime);
+        TOML::GetValue(section, "iSequenceTime"sv, controls.iSequenceTime);
+        TOML::GetValue(section, "bFunctionHotkeys"sv, controls.bFunctionHotkeys);
+
         if (auto subsection = TOML::GetSection(*section, "Keyboard"sv)) {
             TOML::GetValue(subsection, "iHotkey"sv, controls.keyboard.iHotkey);
             TOML::GetValue(subsection, "iModifier"sv, controls.keyboard.iModifier);
+            TOML::GetValue(subsection, "sHotkey"sv, controls.keyboard.sHotkey);
             TOML::GetValue(subsection, "iExtraExit"sv, controls.keyboard.iExtraExit);
         }
 
         if (auto subsection = TOML::GetSection(*section, "Gamepad"sv)) {
             TOML::GetValue(subsection, "iHotkey"sv, controls.gamepad.iHotkey);
             TOML::GetValue(subsection, "iModifier"sv, controls.gamepad.iModifier);
+            TOML::GetValue(subsection, "sHotkey"sv, controls.gamepad.sHotkey);
             TOML::GetValue(subsection, "iExtraExit"sv, controls.gamepad.iExtraExit);
         }
     }
+
+    if (auto section = TOML::GetSection(data, "Explorer"sv)) {
+        TOML::GetValue(section, "bPrefetch"sv, explorer.bPrefetch);
+        TOML::GetValue(section, "iRefreshInterval"sv, explorer.iRefreshInterval);
+        TOML::GetValue(section, "iScanThreads"sv, explorer.iScanThreads);
+        TOML::GetValue(section, "bSearch"sv, explorer.bSearch);
+    }
+
+    if (auto section = TOML::GetSection(data, "Renderer"sv)) {
+        TOML::GetValue(section, "bSkipIdleFrames"sv, renderer.bSkipIdleFrames);
+        TOML::GetValue(section, "iMaxUpdateRate"sv, renderer.iMaxUpdateRate);
+        TOML::GetValue(section, "bFrameStats"sv, renderer.bFrameStats);
+    }
 }
 
 void Configuration::SaveImpl(const std::filesystem::path& a_path) const
@@ -103,10 +123,15 @@ void Configuration::SaveImpl(const std::filesystem::path& a_path) const
     }
     {
         toml::table section;
+        TOML::SetValue(section, "iDoubleTapTime"sv, controls.iDoubleTapTime);
+        TOML::SetValue(section, "iHoldTime"sv, controls.iHoldTime);
+        TOML::SetValue(section, "iSequenceTime"sv, controls.iSequenceTime);
+        TOML::SetValue(section, "bFunctionHotkeys"sv, controls.bFunctionHotkeys);
         {
             toml::table subsection;
             TOML::SetValue(subsection, "iHotkey"sv, controls.keyboard.iHotkey);
             TOML::SetValue(subsection, "iModifier"sv, controls.keyboard.iModifier);
+            TOML::SetValue(subsection, "sHotkey"sv, controls.keyboard.sHotkey);
             TOML::SetValue(subsection, "iExtraExit"sv, controls.keyboard.iExtraExit);
             TOML::SetSection(section, "Keyboard"sv, std::move(subsection));
         }
@@ -114,11 +139,27 @@ void Configuration::SaveImpl(const std::filesystem::path& a_path) const
             toml::table subsection;
             TOML::SetValue(subsection, "iHotkey"sv, controls.gamepad.iHotkey);
             TOML::SetValue(subsection, "iModifier"sv, controls.gamepad.iModifier);
+            TOML::SetValue(subsection, "sHotkey"sv, controls.gamepad.sHotkey);
             TOML::SetValue(subsection, "iExtraExit"sv, controls.gamepad.iExtraExit);
             TOML::SetSection(section, "Gamepad"sv, std::move(subsection));
         }
         TOML::SetSection(data, "Controls"sv, std::move(section));
     }
+    {
+        toml::table section;
+        TOML::SetValue(section, "bPrefetch"sv, explorer.bPrefetch);
+        TOML::SetValue(section, "iRefreshInterval"sv, explorer.iRefreshInterval);
+        TOML::SetValue(section, "iScanThreads"sv, explorer.iScanThreads);
+        TOML::SetValue(section, "bSearch"sv, explorer.bSearch);
+        TOML::SetSection(data, "Explorer"sv, std::move(section));
+    }
+    {
+        toml::table section;
+        TOML::SetValue(section, "bSkipIdleFrames"sv, renderer.bSkipIdleFrames);
+        TOML::SetValue(section, "iMaxUpdateRate"sv, renderer.iMaxUpdateRate);
+        TOML::SetValue(section, "bFrameStats"sv, renderer.bFrameStats);
+        TOML::SetSection(data, "Renderer"sv, std::move(section));
+    }
     TOML::SaveFile(a_path, data);
 }
 
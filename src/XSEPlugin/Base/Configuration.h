@@ -7,15 +7,16 @@ class Configuration final : public SingletonEx<Configuration>
     friend class SingletonEx<Configuration>;
 
 public:
-    /// Initialize configuration and replace internal singleton.
+    /// Load configuration and publish it as the current snapshot.
     ///
     /// @param a_abort
     ///   If true, terminate this process when error occurred;
     ///   otherwise, throw exception.
     ///
     /// @note
-    ///   Assume caller has already acquired unique lock before calling,
-    ///   and will increase version after calling.
+    ///   Files are parsed without holding any lock, and readers of the
+    ///   previous snapshot are not blocked. Version is increased after
+    ///   publishing.
     static void Init(bool a_abort = true);
 
     struct General
@@ -30,6 +31,7 @@ public:
         {
             std::uint32_t iHotkey{ REX::W32::DIK_F1 };
             std::uint32_t iModifier{ 0 };
+            std::string   sHotkey;
             std::uint32_t iExtraExit{ REX::W32::DIK_ESCAPE };
         };
 
@@ -37,13 +39,34 @@ public:
         {
             std::uint32_t iHotkey{ 0 };
             std::uint32_t iModifier{ 0 };
+            std::string   sHotkey;
             std::uint32_t iExtraExit{ 0 };
         };
 
+        std::uint32_t iDoubleTapTime{ 300 };
+        std::uint32_t iHoldTime{ 500 };
+        std::uint32_t iSequenceTime{ 1000 };
+        bool          bFunctionHotkeys{ true };
+
         Keyboard keyboard;
         Gamepad  gamepad;
     };
 
+    struct Explorer
+    {
+        bool          bPrefetch{ true };
+        std::uint32_t iRefreshInterval{ 0 };
+        std::uint32_t iScanThreads{ 4 };
+        bool          bSearch{ false };
+    };
+
+    struct Renderer
+    {
+        bool          bSkipIdleFrames{ true };
+        std::uint32_t iMaxUpdateRate{ 0 };
+        bool          bFrameStats{ false };
+    };
+
     struct Fonts
     {
         struct General
@@ -125,6 +148,8 @@ public:
 #pragma warning(disable: 4324)
     alignas(std::hardware_destructive_interference_size) General general;
     alignas(std::hardware_destructive_interference_size) Controls controls;
+    alignas(std::hardware_destructive_interference_size) Explorer explorer;
+    alignas(std::hardware_destructive_interference_size) Renderer renderer;
     alignas(std::hardware_destructive_interference_size) Fonts fonts;
     alignas(std::hardware_destructive_interference_size) Styles styles;
 #pragma warning(pop)
@@ -66,9 +66,9 @@ namespace
 
 void Translation::Init(bool a_abort)
 {
-    auto tmp = std::unique_ptr<Translation, Deleter>{ new Translation };
+    auto tmp = Make();
     tmp->Load(a_abort);
-    _singleton = std::move(tmp);
+    Publish(std::move(tmp));
 }
 
 void Translation::Load(bool a_abort)
@@ -9,15 +9,16 @@ class Translation final : public SingletonEx<Translation>
     friend class SingletonEx<Translation>;
 
 public:
-    /// Initialize translation and replace internal singleton.
+    /// Load translation and publish it as the current snapshot.
     ///
     /// @param a_abort
     ///   If true, terminate this process when error occurred;
     ///   otherwise, throw exception.
     ///
     /// @note
-    ///   Assume caller has already acquired unique lock before calling,
-    ///   and will increase version after calling.
+    ///   Files are parsed without holding any lock, and readers of the
+    ///   previous snapshot are not blocked. Version is increased after
+    ///   publishing.
     static void Init(bool a_abort = true);
 
     /// Lookup translation text.
@@ -1,10 +1,91 @@
 #include "Core.h"
 
+#include <XSEPlugin/Base/Configuration.h>
+#include <XSEPlugin/Index.h>
+#include <XSEPlugin/SymbolCache.h>
 #include <XSEPlugin/Util/TOML.h>
-#include <XSEPlugin/Util/Win.h>
+
+namespace
+{
+    inline bool IsPrefetchEnabled()
+    {
+        return Configuration::GetSingleton()->explorer.bPrefetch;
+    }
+
+    inline std::uint32_t GetRefreshInterval()
+    {
+        return Configuration::GetSingleton()->explorer.iRefreshInterval;
+    }
+
+    void WriteToBuffer(MFMAPI_Writer* a_writer, const char* a_data, std::size_t a_len)
+    {
+        try {
+            reinterpret_cast<ChunkedBuffer*>(a_writer)->append(a_data, a_len);
+        } catch (const std::exception& e) {
+            // Never throw into mod.
+            SKSE::log::error("Failed to write message: {}.", e.what());
+        }
+    }
+
+    inline std::uint32_t GetScanThreads()
+    {
+        return std::clamp(Configuration::GetSingleton()->explorer.iScanThreads, 1u, 64u);
+    }
+
+    inline bool IsSearchEnabled()
+    {
+        return Configuration::GetSingleton()->explorer.bSearch;
+    }
+
+    inline bool IsFunctionHotkeysEnabled()
+    {
+        return Configuration::GetSingleton()->controls.bFunctionHotkeys;
+    }
+}
+
+MFM_Fingerprint MFM_Fingerprint::Probe(const std::filesystem::path& a_path) noexcept
+{
+    std::error_code ec;
+    MFM_Fingerprint fingerprint;
+    fingerprint.mtime = std::filesystem::last_write_time(a_path, ec);
+    if (ec) {
+        return {};
+    }
+    for (std::filesystem::directory_iterator it{ a_path, ec }, end; !ec && it != end; it.increment(ec)) {
+        ++fingerprint.count;
+    }
+    if (ec) {
+        return {};
+    }
+    return fingerprint;
+}
+
+MFM_FileStamp MFM_FileStamp::Probe(const std::filesystem::path& a_path) noexcept
+{
+    std::error_code ec;
+    MFM_FileStamp   stamp;
+    stamp.mtime = std::filesystem::last_write_time(a_path, ec);
+    if (!ec) {
+        stamp.size = std::filesystem::file_size(a_path, ec);
+    }
+    return ec ? MFM_FileStamp{} : stamp;
+}
 
 MFM_Function MFM_Function::Get(const std::filesystem::path& a_path)
 {
+    return Get(a_path, MFM_FileStamp::Probe(a_path));
+}
+
+MFM_Function MFM_Function::Get(const std::filesystem::path& a_path, const MFM_FileStamp& a_stamp)
+{
+    auto index = Index::GetSingleton();
+    if (a_stamp.IsValid()) {
+        if (auto func = index->FindFunction(a_path, a_stamp)) {
+            SKSE::log::debug("Get function from index: dll = \"{}\", api = \"{}\".", func->dll, func->api);
+            return std::move(*func);
+        }
+    }
+
     MFM_Function func;
 
     auto data = TOML::LoadFile(a_path);
@@ -25,15 +106,25 @@ MFM_Function MFM_Function::Get(const std::filesystem::path& a_path)
     TOML::GetValue(data, "postAction"sv, postAction);
     func.postAction = MFMAPI_PostAction_StrToEnum(postAction);
 
-    SKSE::log::info("Get function: dll = \"{}\", api = \"{}\", type = \"{}\", preAction = \"{}\", postAction = \"{}\".",
-        func.dll, func.api, type, preAction, postAction);
+    std::string thread;
+    TOML::GetValue(data, "thread"sv, thread);
+    func.thread = MFMAPI_Thread_StrToEnum(thread);
+
+    TOML::GetValue(data, "hotkey"sv, func.hotkey);
+
+    SKSE::log::debug("Get function: dll = \"{}\", api = \"{}\", type = \"{}\", preAction = \"{}\", postAction = \"{}\", "
+                     "thread = \"{}\", hotkey = \"{}\".",
+        func.dll, func.api, type, preAction, postAction, thread, func.hotkey);
+
+    if (a_stamp.IsValid()) {
+        index->PutFunction(a_path, a_stamp, func);
+    }
     return func;
 }
 
 void MFM_Function::operator()() const
 {
-    auto dllPath = StrToPath(dll);
-    auto func = Win::GetModuleFunc<MFMAPI_Void>(dllPath.c_str(), api.c_str());
+    auto func = reinterpret_cast<MFMAPI_Void>(Symbol());
     if (!func) {
         auto msg = std::format("Invalid function: dll = \"{}\", api = \"{}\"", dll, api);
         throw std::runtime_error(msg);
@@ -43,8 +134,7 @@ void MFM_Function::operator()() const
 
 void MFM_Function::operator()(char* a_msg, std::size_t a_len) const
 {
-    auto dllPath = StrToPath(dll);
-    auto func = Win::GetModuleFunc<MFMAPI_Message>(dllPath.c_str(), api.c_str());
+    auto func = reinterpret_cast<MFMAPI_Message>(Symbol());
     if (!func) {
         auto msg = std::format("Invalid function: dll = \"{}\", api = \"{}\"", dll, api);
         throw std::runtime_error(msg);
@@ -52,48 +142,767 @@ void MFM_Function::operator()(char* a_msg, std::size_t a_len) const
     return func(a_msg, a_len);
 }
 
-MFM_Node::MFM_Node(const std::filesystem::path& a_path, Type a_type) : MFM_Node(a_path, a_type, this) {}
+void MFM_Function::operator()(ChunkedBuffer& a_buffer) const
+{
+    auto func = reinterpret_cast<MFMAPI_StreamBox>(Symbol());
+    if (!func) {
+        auto msg = std::format("Invalid function: dll = \"{}\", api = \"{}\"", dll, api);
+        throw std::runtime_error(msg);
+    }
+    return func(reinterpret_cast<MFMAPI_Writer*>(std::addressof(a_buffer)), WriteToBuffer);
+}
 
-MFM_Node::MFM_Node(const std::filesystem::path& a_path, Type a_type, MFM_Node* a_parent) :
-    path(a_path.generic_wstring()), type(a_type), parent(a_parent)
+std::string MFM_Function::Invoke() const
 {
     switch (type) {
-    case Type::kRegular:
-        name = PathToStr(path.stem());
-        break;
-    case Type::kDirectory:
-        name = PathToStr(path.filename());
-        BuildChildren();
-        break;
+    case MFMAPI_Type::kVoid:
+        (*this)();
+        return {};
+    case MFMAPI_Type::kMessage:
+    case MFMAPI_Type::kMessageBox:
+        {
+            // Fixed-size buffer of old ABI, which is expected to be zero-filled.
+            std::string msg(0x4000, '\0');
+            (*this)(msg.data(), msg.size());
+            msg.back() = '\0';
+            msg.resize(std::strlen(msg.c_str()));
+            return msg;
+        }
+    case MFMAPI_Type::kStreamBox:
+        {
+            ChunkedBuffer buffer;
+            (*this)(buffer);
+            return buffer.str();
+        }
     }
+    return {};
 }
 
-void MFM_Node::BuildChildren()
+void* MFM_Function::Symbol() const { return symbol ? symbol : SymbolCache::GetSingleton()->Resolve(dll, api); }
+
+std::shared_ptr<const MFM_Function> MFM_FunctionCache::Find(std::string_view a_relPath) const
 {
-    auto st = std::filesystem::status(path);
+    std::shared_lock lock{ _mutex };
+    if (auto it = _entries.find(a_relPath); it != _entries.end()) {
+        return it->second.func;
+    }
+    return nullptr;
+}
 
-    if (!std::filesystem::exists(st)) {
-        SKSE::log::warn("\"{}\" does not exist.", PathToStr(path));
+std::shared_ptr<const MFM_Function> MFM_FunctionCache::Load(const std::filesystem::path& a_path,
+    std::string_view a_relPath)
+{
+    auto stamp = MFM_FileStamp::Probe(a_path);
+
+    std::shared_ptr<const MFM_Function> cached;
+    {
+        std::shared_lock lock{ _mutex };
+        if (auto it = _entries.find(a_relPath); it != _entries.end() && it->second.stamp == stamp) {
+            cached = it->second.func;
+        }
+    }
+    if (cached && cached->IsAvailable()) {
+        return cached;
+    }
+
+    auto func = std::make_shared<MFM_Function>(cached ? *cached : MFM_Function::Get(a_path, stamp));
+    func->symbol = SymbolCache::GetSingleton()->Resolve(func->dll, func->api);
+    if (cached && !func->IsAvailable()) {
+        return cached;
+    }
+
+    std::unique_lock lock{ _mutex };
+    _entries.insert_or_assign(std::string{ a_relPath }, Entry{ stamp, func });
+    return func;
+}
+
+MFM_Snapshot::MFM_Snapshot(const std::filesystem::path& a_root) : _root(a_root.generic_wstring())
+{
+    auto  id = _nodes.grow(1);
+    auto& node = _nodes[id];
+    node.name = Intern(PathToStr(_root.filename()));
+    node.path = Intern(""sv);
+    node.parent = id;
+    node.type = MFM_Node::Type::kDirectory;
+}
+
+std::filesystem::path MFM_Snapshot::Path(MFM_NodeID a_id) const
+{
+    if (auto path = RelativePath(a_id); !path.empty()) {
+        return _root / StrToPath(path);
+    }
+    return _root;
+}
+
+MFM_NodeID MFM_Snapshot::FindChild(MFM_NodeID a_id, std::string_view a_fileName) const noexcept
+{
+    // Children are sorted by file name.
+    auto children = Children(a_id);
+    auto it =
+        std::ranges::lower_bound(children, a_fileName, {}, [this](MFM_NodeID a_child) { return FileName(a_child); });
+    return (it != children.end() && FileName(*it) == a_fileName) ? *it : root;
+}
+
+MFM_NodeID MFM_Snapshot::FindPath(std::string_view a_relPath) const
+{
+    auto id = root;
+    for (auto fileName : std::views::split(a_relPath, '/')) {
+        Expand(id);
+        id = FindChild(id, std::string_view{ fileName.begin(), fileName.end() });
+        if (id == root) {
+            break;
+        }
+    }
+    return id;
+}
+
+void MFM_Snapshot::Expand(MFM_NodeID a_id) const
+{
+    if (_nodes[a_id].type != MFM_Node::Type::kDirectory || IsExpanded(a_id)) {
         return;
     }
 
+    auto path = Path(a_id);
+    auto listing = List(path);
+    if (Commit(a_id, listing)) {
+        SKSE::log::trace("Expand \"{}\" ({} entries).", PathToStr(path), listing.entries.size());
+    }
+}
+
+void MFM_Snapshot::ExpandAll(ThreadPool& a_pool, MFM_NodeID a_id) const
+{
+    TaskGroup group{ a_pool };
+    ExpandAll(a_id, group);
+    group.Wait();
+}
+
+std::shared_ptr<const MFM_Snapshot> MFM_Snapshot::Rescan(ThreadPool& a_pool, MFM_RescanStats& a_stats,
+    std::vector<MFM_NodeID>* a_changed) const
+{
+    // Scanning is dominated by filesystem latency, so fan it out.
+    auto snapshot = std::make_shared<MFM_Snapshot>(_root);
+    if (!IsExpanded(root)) {
+        return snapshot;
+    }
+
+    ScanResult result;
+    {
+        TaskGroup group{ a_pool };
+        Scan(root, result, group, a_stats);
+        group.Wait();
+    }
+
+    // Commit on this thread in tree order, so node IDs are deterministic.
+    snapshot->Apply(root, result, a_changed);
+    return snapshot;
+}
+
+MFM_Listing MFM_Snapshot::List(const std::filesystem::path& a_path)
+{
+    auto fingerprint = MFM_Fingerprint::Probe(a_path);
+    if (fingerprint.mtime == std::filesystem::file_time_type::min()) {
+        return Enumerate(a_path, fingerprint.mtime);
+    }
+
+    auto index = Index::GetSingleton();
+    if (auto listing = index->FindListing(a_path, fingerprint)) {
+        return std::move(*listing);
+    }
+
+    auto listing = Enumerate(a_path, fingerprint.mtime);
+    index->PutListing(a_path, listing);
+    return listing;
+}
+
+MFM_Listing MFM_Snapshot::Enumerate(const std::filesystem::path& a_path, std::filesystem::file_time_type a_mtime)
+{
+    MFM_Listing listing;
+    listing.fingerprint.mtime = a_mtime;
+
+    auto st = std::filesystem::status(a_path);
+
+    if (!std::filesystem::exists(st)) {
+        SKSE::log::warn("\"{}\" does not exist.", PathToStr(a_path));
+        return listing;
+    }
+
     if (!std::filesystem::is_directory(st)) {
-        SKSE::log::error("\"{}\" is not a directory.", PathToStr(path));
-        return;
+        SKSE::log::error("\"{}\" is not a directory.", PathToStr(a_path));
+        return listing;
     }
 
-    for (const auto& entry : std::filesystem::directory_iterator{ path }) {
+    for (const auto& entry : std::filesystem::directory_iterator{ a_path }) {
+        ++listing.fingerprint.count;
         if (entry.is_regular_file()) {
-#pragma warning(push)
-#pragma warning(disable: 4458)
             if (const auto& path = entry.path(); path.extension().native() == L".toml"sv) {
-                children.push_back(std::make_unique<MFM_Node>(path, Type::kRegular, this));
+                listing.entries.push_back({ PathToStr(path.filename()), MFM_Node::Type::kRegular });
             }
-#pragma warning(pop)
         } else if (entry.is_directory()) {
-            children.push_back(std::make_unique<MFM_Node>(entry.path(), Type::kDirectory, this));
+            listing.entries.push_back({ PathToStr(entry.path().filename()), MFM_Node::Type::kDirectory });
         }
     }
 
-    std::ranges::sort(children, [](auto&& lhs, auto&& rhs) { return *lhs < *rhs; });
+    std::ranges::sort(listing.entries, {}, &MFM_Entry::fileName);
+    return listing;
+}
+
+MFM_StringRef MFM_Snapshot::Intern(std::string_view a_str) const
+{
+    auto size = static_cast<std::uint32_t>(a_str.size());
+    auto offset = _strings.grow_contiguous(size + 1);
+    auto data = std::addressof(_strings[offset]);
+    std::memcpy(data, a_str.data(), size);
+    data[size] = '\0';
+    return { offset, size };
+}
+
+bool MFM_Snapshot::Commit(MFM_NodeID a_id, const MFM_Listing& a_listing) const
+{
+    std::scoped_lock lock{ _mutex };
+
+    auto& node = _nodes[a_id];
+    if (node.expanded.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    auto count = static_cast<std::uint32_t>(a_listing.entries.size());
+    auto first = _nodes.grow(count);
+
+    auto                          parentPath = RelativePath(a_id);
+    std::string                   path;
+    std::vector<std::string_view> glyphs;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const auto& entry = a_listing.entries[i];
+
+        path.assign(parentPath);
+        if (!path.empty()) {
+            path += '/';
+        }
+        path += entry.fileName;
+
+        auto& child = _nodes[first + i];
+        child.path = Intern(path);
+        child.parent = a_id;
+        child.type = entry.type;
+
+        switch (entry.type) {
+        case MFM_Node::Type::kRegular:
+            // Strip ".toml".
+            child.name = Intern(std::string_view{ entry.fileName }.substr(0, entry.fileName.size() - 5));
+            break;
+        case MFM_Node::Type::kDirectory:
+            // Share the null-terminated tail of path.
+            child.name = { child.path.offset + child.path.size - static_cast<std::uint32_t>(entry.fileName.size()),
+                static_cast<std::uint32_t>(entry.fileName.size()) };
+            break;
+        }
+        UTF8::CollectNonASCII(String(child.name), glyphs);
+    }
+
+    if (!glyphs.empty()) {
+        std::ranges::sort(glyphs);
+        auto [last, end] = std::ranges::unique(glyphs);
+        glyphs.erase(last, end);
+
+        std::string joined;
+        for (auto glyph : glyphs) {
+            joined += glyph;
+        }
+        node.glyphs = Intern(joined);
+    }
+
+    node.firstChild = first;
+    node.childCount = count;
+    node.fingerprint = a_listing.fingerprint;
+    node.expanded.store(true, std::memory_order_release);
+    return true;
+}
+
+void MFM_Snapshot::Scan(MFM_NodeID a_id, ScanResult& a_result, TaskGroup& a_group, MFM_RescanStats& a_stats) const
+{
+    std::atomic_ref{ a_stats.visited }.fetch_add(1, std::memory_order_relaxed);
+
+    const auto& node = _nodes[a_id];
+    auto        path = Path(a_id);
+
+    auto& listing = a_result.listing;
+    if (MFM_Fingerprint::Probe(path) == node.fingerprint) {
+        listing.fingerprint = node.fingerprint;
+        listing.entries.reserve(node.childCount);
+        for (auto child : Children(a_id)) {
+            listing.entries.push_back({ std::string{ FileName(child) }, _nodes[child].type });
+        }
+    } else {
+        std::atomic_ref{ a_stats.rescanned }.fetch_add(1, std::memory_order_relaxed);
+        listing = List(path);
+        a_result.changed = true;
+    }
+
+    // Fan out subtrees that still exist.
+    for (std::uint32_t i = 0; i < listing.entries.size(); ++i) {
+        const auto& entry = listing.entries[i];
+        if (entry.type != MFM_Node::Type::kDirectory) {
+            continue;
+        }
+        if (auto child = FindChild(a_id, entry.fileName);
+            child != root && _nodes[child].type == MFM_Node::Type::kDirectory && IsExpanded(child)) {
+            auto result = a_result.children.emplace_back(i, std::make_unique<ScanResult>()).second.get();
+            a_group.Run([this, child, result, &a_group, &a_stats]() { Scan(child, *result, a_group, a_stats); });
+        }
+    }
+}
+
+void MFM_Snapshot::Apply(MFM_NodeID a_id, const ScanResult& a_result, std::vector<MFM_NodeID>* a_changed) const
+{
+    Commit(a_id, a_result.listing);
+    if (a_changed && a_result.changed) {
+        a_changed->push_back(a_id);
+    }
+
+    auto first = _nodes[a_id].firstChild;
+    for (const auto& [index, result] : a_result.children) {
+        Apply(first + index, *result, a_changed);
+    }
+}
+
+void MFM_Snapshot::ExpandAll(MFM_NodeID a_id, TaskGroup& a_group) const
+{
+    try {
+        Expand(a_id);
+    } catch (const std::exception& e) {
+        // Leave it unexpanded, like an empty directory.
+        SKSE::log::error("Failed to expand \"{}\": {}.", PathToStr(Path(a_id)), e.what());
+        return;
+    }
+
+    for (auto child : Children(a_id)) {
+        if (_nodes[child].type == MFM_Node::Type::kDirectory) {
+            a_group.Run([this, child, &a_group]() { ExpandAll(child, a_group); });
+        }
+    }
+}
+
+void MFM_Tree::CurrentPath(MFM_NodeID a_id)
+{
+    currentPath = a_id;
+    ++currentPathVersion;
+    if (auto path = snapshot->RelativePath(a_id); path.empty()) {
+        currentPathStr = prefix;
+    } else {
+        currentPathStr = std::format("{}/{}", prefix, path);
+    }
+
+    expanding = (*snapshot)[a_id].type == MFM_Node::Type::kDirectory && !snapshot->IsExpanded(a_id);
+    if (expanding) {
+        _pool.Submit([this, current = snapshot, a_id, ticket = ++expandTicket]() {
+            try {
+                current->Expand(a_id);
+            } catch (const std::exception& e) {
+                // Shown as empty.
+                SKSE::log::warn("Failed to expand \"{}\": {}.", PathToStr(current->Path(a_id)), e.what());
+            }
+            _expandedTicket.store(ticket);
+            _changeVersion.fetch_add(1);
+        });
+    }
+
+    // Invalidate previous prefetch, even if there is nothing to prefetch yet.
+    Prefetch(a_id);
+}
+
+void MFM_Tree::Prefetch(MFM_NodeID a_id)
+{
+    // Invalidate previous prefetch, user has already navigated away.
+    auto version = _prefetchVersion.fetch_add(1) + 1;
+
+    if (!IsPrefetchEnabled()) {
+        return;
+    }
+
+    // Prefetch each child as a task, and keep snapshot alive until it finishes.
+    for (auto child : snapshot->Children(a_id)) {
+        _pool.Submit([this, current = snapshot, child, version]() {
+            if (_prefetchVersion.load() != version) {
+                return;
+            }
+            try {
+                switch ((*current)[child].type) {
+                case MFM_Node::Type::kRegular:
+                    {
+                        auto func = _functions.Load(current->Path(child), current->RelativePath(child));
+                        current->SetAvailable(child, func->IsAvailable());
+                    }
+                    break;
+                case MFM_Node::Type::kDirectory:
+                    current->Expand(child);
+                    break;
+                }
+            } catch (const std::exception& e) {
+                // Leave it to foreground, which reports error on click.
+                SKSE::log::debug("Failed to prefetch \"{}\": {}.", PathToStr(current->Path(child)), e.what());
+            }
+            _changeVersion.fetch_add(1);
+        });
+    }
+}
+
+std::shared_ptr<const MFM_Function> MFM_Tree::Function(MFM_NodeID a_id)
+{
+    auto func = _functions.Find(snapshot->RelativePath(a_id));
+    if (!func) {
+        func = _functions.Load(snapshot->Path(a_id), snapshot->RelativePath(a_id));
+    }
+    snapshot->SetAvailable(a_id, func->IsAvailable());
+    return func;
+}
+
+void MFM_Tree::Refresh(MFM_RescanStats& a_stats)
+{
+    std::scoped_lock lock{ _refreshMutex };
+
+    MFM_RescanStats         stats;
+    std::vector<MFM_NodeID> changed;
+    auto                    newSnapshot = latest.load()->Rescan(_pool, stats, _searchReady ? &changed : nullptr);
+
+    a_stats.visited += stats.visited;
+    a_stats.rescanned += stats.rescanned;
+
+    if (stats.rescanned == 0) {
+        return;
+    }
+
+    if (!changed.empty()) {
+        // Search covers whole tree, so expand new subdirectories before indexing them.
+        for (auto id : changed) {
+            for (auto child : newSnapshot->Children(id)) {
+                if ((*newSnapshot)[child].type == MFM_Node::Type::kDirectory && !newSnapshot->IsExpanded(child)) {
+                    newSnapshot->ExpandAll(_pool, child);
+                }
+            }
+        }
+
+        std::unique_lock searchLock{ _searchMutex };
+        for (auto id : changed) {
+            _search.Update(*newSnapshot, id);
+        }
+        _searchVersion.fetch_add(1);
+    }
+
+    latest.store(std::move(newSnapshot));
+    _changeVersion.fetch_add(1);
+}
+
+void MFM_Tree::BuildSearch()
+{
+    std::scoped_lock lock{ _refreshMutex };
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto current = latest.load();
+    current->ExpandAll(_pool, MFM_Snapshot::root);
+
+    // Build aside, so that search is not blocked meanwhile.
+    SearchState search;
+    search.AddSubtree(*current, MFM_Snapshot::root);
+    auto size = search.index.Size();
+    {
+        std::unique_lock searchLock{ _searchMutex };
+        _search = std::move(search);
+    }
+    _searchReady = true;
+    _searchVersion.fetch_add(1);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    SKSE::log::debug("Build search index of \"{}\": {} entries in {} ms.", PathToStr(current->RootPath()), size,
+        elapsed.count());
+}
+
+void MFM_Tree::CollectHotkeys(std::span<const std::string> a_paths, std::vector<MFM_HotkeyBinding>& a_out)
+{
+    // Index keys may mix separators.
+    auto normalize = [](std::string a_path) {
+        std::ranges::replace(a_path, '\\', '/');
+        return a_path;
+    };
+    auto root = normalize(PathToStr(latest.load()->RootPath())) + '/';
+
+    for (const auto& path : a_paths) {
+        auto normalized = normalize(path);
+        if (!normalized.starts_with(root)) {
+            continue;
+        }
+        auto relPath = std::string_view{ normalized }.substr(root.size());
+        try {
+            auto func = _functions.Load(StrToPath(path), relPath);
+            if (func->hotkey.empty()) {
+                continue;
+            }
+            // Invoking it would throw, with no menu to report to.
+            if (!func->IsAvailable()) {
+                SKSE::log::warn("Ignore hotkey \"{}\" of \"{}\": dll = \"{}\", api = \"{}\" is not available.",
+                    func->hotkey, path, func->dll, func->api);
+                continue;
+            }
+            a_out.push_back({ this, std::string{ relPath }, std::move(func) });
+        } catch (const std::exception& e) {
+            // File may have gone since indexed.
+            SKSE::log::debug("Failed to collect hotkey of \"{}\": {}.", path, e.what());
+        }
+    }
+}
+
+std::vector<MFM_SearchResult> MFM_Tree::Search(std::string_view a_query, std::size_t a_limit)
+{
+    std::vector<MFM_SearchResult> results;
+
+    std::shared_lock lock{ _searchMutex };
+    for (const auto& match : _search.index.Query(a_query, a_limit)) {
+        results.push_back(
+            { this, _search.Path(match.id), std::format("{}/{}", prefix, _search.index.Text(match.id)), match.score });
+    }
+    return results;
+}
+
+void MFM_Tree::SearchState::AddSubtree(const MFM_Snapshot& a_snapshot, MFM_NodeID a_id)
+{
+    auto& docs = dirs[std::string{ a_snapshot.RelativePath(a_id) }];
+    for (auto child : a_snapshot.Children(a_id)) {
+        docs.push_back(Add(a_snapshot, child));
+        if (a_snapshot[child].type == MFM_Node::Type::kDirectory) {
+            AddSubtree(a_snapshot, child);
+        }
+    }
+}
+
+void MFM_Tree::SearchState::RemoveSubtree(std::string_view a_relPath)
+{
+    auto removeDocs = [this](const auto& a_pair) {
+        for (auto id : a_pair.second) {
+            index.Remove(id);
+        }
+    };
+
+    if (auto it = dirs.find(a_relPath); it != dirs.end()) {
+        removeDocs(*it);
+        dirs.erase(it);
+    }
+
+    // Subdirectories sort together from "<path>/".
+    auto prefix = std::format("{}/", a_relPath);
+    auto first = dirs.lower_bound(prefix);
+    auto last = first;
+    for (; last != dirs.end() && last->first.starts_with(prefix); ++last) {
+        removeDocs(*last);
+    }
+    dirs.erase(first, last);
+}
+
+void MFM_Tree::SearchState::Update(const MFM_Snapshot& a_snapshot, MFM_NodeID a_id)
+{
+    auto it = dirs.find(a_snapshot.RelativePath(a_id));
+    if (it == dirs.end()) {
+        AddSubtree(a_snapshot, a_id);
+        return;
+    }
+
+    // Keep documents of children that still exist.
+    std::map<std::string, SearchIndex::DocID, std::less<>> old;
+    for (auto id : it->second) {
+        old.emplace(Path(id), id);
+    }
+
+    std::vector<SearchIndex::DocID> docs;
+    docs.reserve(a_snapshot.Children(a_id).size());
+    for (auto child : a_snapshot.Children(a_id)) {
+        auto type = a_snapshot[child].type;
+        if (auto o = old.find(a_snapshot.RelativePath(child)); o != old.end() && types[o->second] == type) {
+            docs.push_back(o->second);
+            old.erase(o);
+            continue;
+        }
+        docs.push_back(Add(a_snapshot, child));
+        if (type == MFM_Node::Type::kDirectory) {
+            AddSubtree(a_snapshot, child);
+        }
+    }
+
+    for (const auto& [path, id] : old) {
+        index.Remove(id);
+        if (types[id] == MFM_Node::Type::kDirectory) {
+            RemoveSubtree(path);
+        }
+    }
+
+    // Node is not erased above, as it is not a subdirectory of itself.
+    it->second = std::move(docs);
+}
+
+std::string MFM_Tree::SearchState::Path(SearchIndex::DocID a_id) const
+{
+    auto text = index.Text(a_id);
+    return types[a_id] == MFM_Node::Type::kRegular ? std::format("{}.toml", text) : std::string{ text };
+}
+
+SearchIndex::DocID MFM_Tree::SearchState::Add(const MFM_Snapshot& a_snapshot, MFM_NodeID a_id)
+{
+    auto path = a_snapshot.RelativePath(a_id);
+    auto type = a_snapshot[a_id].type;
+    if (type == MFM_Node::Type::kRegular) {
+        // Strip ".toml".
+        path.remove_suffix(5);
+    }
+    auto id = index.Add(path);
+    types.resize(std::max<std::size_t>(types.size(), id + 1));
+    types[id] = type;
+    return id;
+}
+
+void MFM_Tree::Sync()
+{
+    if (expanding && _expandedTicket.load() == expandTicket) {
+        expanding = false;
+        ++currentPathVersion;
+        Prefetch(currentPath);
+    }
+
+    auto newSnapshot = latest.load();
+    if (newSnapshot == snapshot) {
+        return;
+    }
+
+    // File names of current path and its ancestors, excluding root.
+    std::vector<std::string_view> fileNames;
+    for (auto id = currentPath; id != MFM_Snapshot::root; id = (*snapshot)[id].parent) {
+        fileNames.push_back(snapshot->FileName(id));
+    }
+
+    auto target = MFM_Snapshot::root;
+    for (auto it = fileNames.rbegin(); it != fileNames.rend(); ++it) {
+        // Expanded directories are carried over, so stop at a cold one rather than block.
+        if (!newSnapshot->IsExpanded(target)) {
+            break;
+        }
+        auto child = newSnapshot->FindChild(target, *it);
+        if (child == MFM_Snapshot::root || (*newSnapshot)[child].type != MFM_Node::Type::kDirectory) {
+            break;
+        }
+        target = child;
+    }
+
+    snapshot = std::move(newSnapshot);
+    CurrentPath(target);
+    SKSE::log::debug("Adopt new snapshot of \"{}\".", PathToStr(snapshot->RootPath()));
+}
+
+Datastore::Datastore() :
+    pool(GetScanThreads()), modTree(MFM_Path::mod, pool), configTree(MFM_Path::config, pool)
+{
+    ResetCurrentSection();
+
+    BuildSearch();
+    BuildHotkeys();
+
+    std::thread t{ [this]() { Watch(); } };
+    t.detach();
+}
+
+MFM_RescanStats Datastore::Refresh()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Modules may have been loaded since.
+    SymbolCache::GetSingleton()->ForgetMissing();
+
+    MFM_RescanStats stats;
+    modTree.Refresh(stats);
+    configTree.Refresh(stats);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    SKSE::log::debug("Refresh: visited {} directories, rescanned {} directories in {} ms on {} threads.",
+        stats.visited, stats.rescanned, elapsed.count(), pool.ThreadCount());
+
+    // Function files may have been edited, which does not show in directories.
+    BuildHotkeys();
+    return stats;
+}
+
+void Datastore::BuildHotkeys()
+{
+    if (!IsFunctionHotkeysEnabled()) {
+        return;
+    }
+
+    pool.Submit([this]() {
+        auto start = std::chrono::steady_clock::now();
+
+        auto paths = Index::GetSingleton()->FindHotkeyFunctions();
+        auto hotkeys = std::make_shared<std::vector<MFM_HotkeyBinding>>();
+        modTree.CollectHotkeys(paths, *hotkeys);
+        configTree.CollectHotkeys(paths, *hotkeys);
+        auto size = hotkeys->size();
+
+        // Unchanged functions are the same cached objects, so compare them by
+        // address. Publishing resets hotkeys in progress.
+        auto sameBinding = [](const MFM_HotkeyBinding& a_lhs, const MFM_HotkeyBinding& a_rhs) {
+            return a_lhs.tree == a_rhs.tree && a_lhs.path == a_rhs.path && a_lhs.func == a_rhs.func;
+        };
+        {
+            std::scoped_lock lock{ _hotkeyMutex };
+            if (auto old = _hotkeys.load(); !old || !std::ranges::equal(*old, *hotkeys, sameBinding)) {
+                _hotkeys.store(std::move(hotkeys));
+                _hotkeyVersion.fetch_add(1);
+            }
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        SKSE::log::debug("Collect hotkeys: {} functions in {} ms.", size, elapsed.count());
+    });
+}
+
+void Datastore::SaveIndex()
+{
+    pool.Submit([]() { Index::GetSingleton()->Save(); });
+
+    // Functions parsed while menu was open may be bound to hotkeys.
+    BuildHotkeys();
+}
+
+void Datastore::BuildSearch()
+{
+    if (!IsSearchEnabled() || _searchStarted.exchange(true)) {
+        return;
+    }
+
+    pool.Submit([this]() {
+        modTree.BuildSearch();
+        configTree.BuildSearch();
+    });
+}
+
+std::vector<MFM_SearchResult> Datastore::Search(std::string_view a_query, std::size_t a_limit)
+{
+    auto results = modTree.Search(a_query, a_limit);
+    std::ranges::move(configTree.Search(a_query, a_limit), std::back_inserter(results));
+
+    std::ranges::stable_sort(results, std::ranges::greater{}, &MFM_SearchResult::score);
+    if (results.size() > a_limit) {
+        results.resize(a_limit);
+    }
+    return results;
+}
+
+void Datastore::Watch()
+{
+    for (;;) {
+        auto interval = GetRefreshInterval();
+        if (interval == 0) {
+            // Disabled, check again later in case configuration is reloaded.
+            std::this_thread::sleep_for(std::chrono::seconds{ 1 });
+            continue;
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds{ interval });
+        (void)Refresh();
+    }
 }
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <XSEPlugin/Function.h>
+#include <XSEPlugin/Util/ChunkedBuffer.h>
+#include <XSEPlugin/Util/ChunkedVector.h>
+#include <XSEPlugin/Util/SearchIndex.h>
 #include <XSEPlugin/Util/Singleton.h>
+#include <XSEPlugin/Util/ThreadPool.h>
+#include <XSEPlugin/Util/UTF8.h>
 
 struct MFM_Path
 {
@@ -11,76 +16,456 @@ struct MFM_Path
     static inline const std::filesystem::path config{ L"Data/SKSE/Plugins/ccld_ModFunctionMenu/Config"sv };
 };
 
+/// The state of a function file when it was parsed.
+struct MFM_FileStamp
+{
+    /// Probe the last write time and size of a file. Return min time on failure.
+    [[nodiscard]] static MFM_FileStamp Probe(const std::filesystem::path& a_path) noexcept;
+
+    [[nodiscard]] bool IsValid() const noexcept { return mtime != std::filesystem::file_time_type::min(); }
+
+    friend bool operator==(const MFM_FileStamp&, const MFM_FileStamp&) = default;
+
+    std::filesystem::file_time_type mtime{ std::filesystem::file_time_type::min() };
+    std::uintmax_t                  size{ 0 };
+};
+
 struct MFM_Function
 {
     [[nodiscard]] static MFM_Function Get(const std::filesystem::path& a_path);
+    [[nodiscard]] static MFM_Function Get(const std::filesystem::path& a_path, const MFM_FileStamp& a_stamp);
 
     void operator()() const;
     void operator()(char* a_msg, std::size_t a_len) const;
+    void operator()(ChunkedBuffer& a_buffer) const;
+
+    /// Invoke function according to its type, and collect its message unless
+    /// it is Void.
+    [[nodiscard]] std::string Invoke() const;
+
+    /// Whether its module is loaded and exports it, as of last resolution.
+    [[nodiscard]] bool IsAvailable() const noexcept { return symbol != nullptr; }
 
     std::string       dll;
     std::string       api;
     MFMAPI_Type       type{ MFMAPI_Type::kVoid };
     MFMAPI_PreAction  preAction{ MFMAPI_PreAction::kNone };
     MFMAPI_PostAction postAction{ MFMAPI_PostAction::kNone };
+    MFMAPI_Thread     thread{ MFMAPI_Thread::kRender };
+    std::string       hotkey;             // Invoke without opening menu, in syntax of CLib::HotkeySet::Parse.
+    void*             symbol{ nullptr };  // Resolved when loaded into cache.
+
+private:
+    /// The resolved symbol, or resolve it again if missing.
+    [[nodiscard]] void* Symbol() const;
 };
 
-class MFM_Node
+/// The state of a directory when its children were enumerated.
+struct MFM_Fingerprint
 {
-public:
-    enum class Type : std::uint32_t
+    /// Probe the last write time and entry count of a directory. Return min
+    /// time on failure.
+    ///
+    /// The count is checked as well, since the time of a virtual directory
+    /// merged by VFS is the time of only one of the real ones, and does not
+    /// change when an entry of another is added or removed.
+    [[nodiscard]] static MFM_Fingerprint Probe(const std::filesystem::path& a_path) noexcept;
+
+    friend bool operator==(const MFM_Fingerprint&, const MFM_Fingerprint&) = default;
+
+    std::filesystem::file_time_type mtime{ std::filesystem::file_time_type::min() };
+    std::uint32_t                   count{ 0 };
+};
+
+struct MFM_RescanStats
+{
+    std::uint32_t visited{ 0 };    // Expanded directories whose fingerprint was probed.
+    std::uint32_t rescanned{ 0 };  // Directories enumerated again.
+};
+
+using MFM_NodeID = std::uint32_t;
+
+/// A string interned in the string pool of snapshot.
+struct MFM_StringRef
+{
+    std::uint32_t offset{ 0 };
+    std::uint32_t size{ 0 };
+};
+
+/// A node record of snapshot.
+///
+/// Children of a directory occupy a contiguous range of IDs, which is
+/// assigned when the directory is expanded.
+struct MFM_Node
+{
+    enum class Type : std::uint8_t
     {
         kRegular = 0,
         kDirectory = 1,
     };
 
-    MFM_Node(const std::filesystem::path& a_path, Type a_type);
-    MFM_Node(const std::filesystem::path& a_path, Type a_type, MFM_Node* a_parent);
+    MFM_StringRef     name;  // Display name.
+    MFM_StringRef     path;  // Relative to tree root, with '/' separator.
+    MFM_StringRef     glyphs;  // Distinct non-ASCII characters of children names, once expanded.
+    MFM_NodeID        parent{ 0 };
+    MFM_NodeID        firstChild{ 0 };
+    std::uint32_t     childCount{ 0 };
+    Type              type{ Type::kRegular };
+    std::atomic<bool> expanded{ false };
+    std::atomic<bool> unavailable{ false };  // Function resolved but not available, of regular node.
+    MFM_Fingerprint   fingerprint;
+};
+
+struct MFM_Entry
+{
+    std::string    fileName;
+    MFM_Node::Type type;
+};
+
+/// The children of a directory, as enumerated from filesystem or loaded from index.
+struct MFM_Listing
+{
+    std::vector<MFM_Entry> entries;  // Sorted by file name.
+    MFM_Fingerprint        fingerprint;
+};
+
+/// An immutable snapshot of a menu section, stored as flat node records and
+/// a string pool.
+///
+/// The only mutations are lazy expansion, which appends records and publishes
+/// them as a whole, so other threads observe either no children or all of
+/// them, and availability of functions once they are resolved.
+class MFM_Snapshot
+{
+public:
+    static constexpr MFM_NodeID root = 0;
+
+    explicit MFM_Snapshot(const std::filesystem::path& a_root);
+
+    MFM_Snapshot(const MFM_Snapshot&) = delete;
+    MFM_Snapshot(MFM_Snapshot&&) = delete;
+    MFM_Snapshot& operator=(const MFM_Snapshot&) = delete;
+    MFM_Snapshot& operator=(MFM_Snapshot&&) = delete;
 
-    friend bool operator==(const MFM_Node& a_lhs, const MFM_Node& a_rhs) noexcept { return a_lhs.path == a_rhs.path; }
+    [[nodiscard]] const MFM_Node& operator[](MFM_NodeID a_id) const noexcept { return _nodes[a_id]; }
 
-    friend std::strong_ordering operator<=>(const MFM_Node& a_lhs, const MFM_Node& a_rhs) noexcept
+    [[nodiscard]] bool IsExpanded(MFM_NodeID a_id) const noexcept
     {
-        return a_lhs.path <=> a_rhs.path;
+        return _nodes[a_id].expanded.load(std::memory_order_acquire);
+    }
+
+    /// Whether the function of regular node has been resolved as unavailable.
+    [[nodiscard]] bool IsUnavailable(MFM_NodeID a_id) const noexcept
+    {
+        return _nodes[a_id].unavailable.load(std::memory_order_relaxed);
+    }
+
+    /// Record availability of the function of regular node, so that drawing
+    /// does not look it up.
+    void SetAvailable(MFM_NodeID a_id, bool a_available) const noexcept
+    {
+        _nodes[a_id].unavailable.store(!a_available, std::memory_order_relaxed);
+    }
+
+    /// The children of node, or empty if not expanded.
+    [[nodiscard]] auto Children(MFM_NodeID a_id) const noexcept
+    {
+        if (!IsExpanded(a_id)) {
+            return std::views::iota(MFM_NodeID{ 0 }, MFM_NodeID{ 0 });
+        }
+        const auto& node = _nodes[a_id];
+        return std::views::iota(node.firstChild, node.firstChild + node.childCount);
+    }
+
+    /// The display name, which is null-terminated.
+    [[nodiscard]] std::string_view Name(MFM_NodeID a_id) const noexcept { return String(_nodes[a_id].name); }
+
+    /// The path relative to tree root, which is null-terminated.
+    [[nodiscard]] std::string_view RelativePath(MFM_NodeID a_id) const noexcept
+    {
+        return String(_nodes[a_id].path);
+    }
+
+    /// The distinct non-ASCII characters of children names as UTF-8, or empty
+    /// if all are ASCII, so that fonts can be fed once per directory.
+    [[nodiscard]] std::string_view Glyphs(MFM_NodeID a_id) const noexcept { return String(_nodes[a_id].glyphs); }
+
+    /// The last component of relative path.
+    [[nodiscard]] std::string_view FileName(MFM_NodeID a_id) const noexcept
+    {
+        auto path = RelativePath(a_id);
+        return path.substr(path.rfind('/') + 1);
+    }
+
+    [[nodiscard]] std::filesystem::path Path(MFM_NodeID a_id) const;
+
+    [[nodiscard]] const std::filesystem::path& RootPath() const noexcept { return _root; }
+
+    /// Find child by file name, or return root if not found.
+    [[nodiscard]] MFM_NodeID FindChild(MFM_NodeID a_id, std::string_view a_fileName) const noexcept;
+
+    /// Find node by path relative to tree root, expanding directories along
+    /// the way. Return root if not found.
+    [[nodiscard]] MFM_NodeID FindPath(std::string_view a_relPath) const;
+
+    /// Enumerate children of directory on first call.
+    ///
+    /// @note
+    ///   Thread-safe. Filesystem is accessed outside lock.
+    void Expand(MFM_NodeID a_id) const;
+
+    /// Expand directory and all its descendants in parallel on the given pool.
+    void ExpandAll(ThreadPool& a_pool, MFM_NodeID a_id) const;
+
+    /// Build a new snapshot that reflects the filesystem.
+    ///
+    /// Only expanded directories are visited, and only those whose fingerprint
+    /// changed are enumerated again. Unchanged children are carried over with
+    /// their expansion state, so the copy never touches unexpanded subtrees.
+    ///
+    /// Directories are scanned in parallel on the given pool, then committed
+    /// in tree order, so node IDs do not depend on scheduling.
+    ///
+    /// @param a_changed
+    ///   If not null, receive directories of the new snapshot that were
+    ///   enumerated again, in tree order.
+    [[nodiscard]] std::shared_ptr<const MFM_Snapshot> Rescan(ThreadPool& a_pool, MFM_RescanStats& a_stats,
+        std::vector<MFM_NodeID>* a_changed = nullptr) const;
+
+    /// The number of node records, for diagnostics.
+    [[nodiscard]] std::uint32_t Size() const
+    {
+        std::scoped_lock lock{ _mutex };
+        return _nodes.size();
     }
 
 private:
-    void BuildChildren();
+    /// The listing of an expanded directory and its expanded subdirectories.
+    struct ScanResult
+    {
+        MFM_Listing listing;
+        bool        changed{ false };  // Enumerated again.
+
+        // Index into listing entries, and the result of that subdirectory.
+        std::vector<std::pair<std::uint32_t, std::unique_ptr<ScanResult>>> children;
+    };
+
+    /// List children of directory from index, or enumerate them if the index
+    /// is missing or stale.
+    [[nodiscard]] static MFM_Listing List(const std::filesystem::path& a_path);
+
+    [[nodiscard]] static MFM_Listing Enumerate(const std::filesystem::path& a_path,
+        std::filesystem::file_time_type a_mtime);
+
+    [[nodiscard]] std::string_view String(MFM_StringRef a_ref) const noexcept
+    {
+        return { std::addressof(_strings[a_ref.offset]), a_ref.size };
+    }
 
+    /// Intern a null-terminated copy of string.
+    MFM_StringRef Intern(std::string_view a_str) const;
+
+    /// Append children records and publish them. Do nothing if expanded.
+    ///
+    /// @return
+    ///   True if children are committed by this call.
+    bool Commit(MFM_NodeID a_id, const MFM_Listing& a_listing) const;
+
+    /// Scan expanded directory, and fan out its expanded subdirectories.
+    void Scan(MFM_NodeID a_id, ScanResult& a_result, TaskGroup& a_group, MFM_RescanStats& a_stats) const;
+
+    /// Commit scan result of directory and its subdirectories.
+    void Apply(MFM_NodeID a_id, const ScanResult& a_result, std::vector<MFM_NodeID>* a_changed) const;
+
+    void ExpandAll(MFM_NodeID a_id, TaskGroup& a_group) const;
+
+    using NodeVector = ChunkedVector<MFM_Node, 0x1000, 0x1000>;
+    using StringPool = ChunkedVector<char, 0x10000, 0x400>;
+
+    std::filesystem::path _root;
+
+    mutable std::mutex _mutex;  // Serialize appending.
+    mutable NodeVector _nodes;
+    mutable StringPool _strings;
+};
+
+/// Parsed functions of a tree, keyed by path relative to tree root.
+///
+/// @note
+///   Thread-safe.
+class MFM_FunctionCache
+{
 public:
-    std::filesystem::path                  path;
-    std::string                            name;
-    Type                                   type;
-    std::vector<std::unique_ptr<MFM_Node>> children;
-    MFM_Node*                              parent;
+    /// The cached function, without touching filesystem. Return nullptr if not
+    /// cached yet.
+    [[nodiscard]] std::shared_ptr<const MFM_Function> Find(std::string_view a_relPath) const;
+
+    /// Parse function if it is not cached, or its file has changed since, and
+    /// resolve its symbol if not resolved yet.
+    std::shared_ptr<const MFM_Function> Load(const std::filesystem::path& a_path, std::string_view a_relPath);
+
+private:
+    struct Entry
+    {
+        MFM_FileStamp                       stamp;
+        std::shared_ptr<const MFM_Function> func;
+    };
+
+    mutable std::shared_mutex                 _mutex;
+    std::map<std::string, Entry, std::less<>> _entries;
 };
 
+class MFM_Tree;
+
+/// A function bound to a hotkey in its file.
+struct MFM_HotkeyBinding
+{
+    MFM_Tree*                           tree;
+    std::string                         path;  // Relative to tree root.
+    std::shared_ptr<const MFM_Function> func;
+};
+
+struct MFM_SearchResult
+{
+    MFM_Tree*    tree;
+    std::string  path;   // Relative to tree root.
+    std::string  label;  // Display path, prefixed with section.
+    std::int32_t score;
+};
+
+/// The tree of a menu section.
+///
+/// The tree is published as immutable snapshots: Refresh() builds a new
+/// snapshot on any thread, and the render thread adopts it in Sync(), so it
+/// never walks a half-built node.
 class MFM_Tree
 {
 public:
-    explicit MFM_Tree(std::filesystem::path a_root) : root(std::move(a_root), MFM_Node::Type::kDirectory)
+    MFM_Tree(const std::filesystem::path& a_root, ThreadPool& a_pool) :
+        snapshot(std::make_shared<const MFM_Snapshot>(a_root)), latest(snapshot),
+        prefix(PathToStr(a_root).substr(MFM_Path::root.native().size() - 1)), _pool(a_pool)
     {
         ResetCurrentPath();
     }
 
-    const MFM_Node* CurrentPath() const noexcept { return currentPath; }
-    void            CurrentPath(const MFM_Node& a_node) { CurrentPath(std::addressof(a_node)); }
-    void            CurrentPath(const MFM_Node* a_node)
-    {
-        currentPath = a_node;
-        currentPathStr = PathToStr(a_node->path).substr(MFM_Path::root.native().size() - 1);
-    }
+    /// Rescan the latest snapshot and publish the result.
+    void Refresh(MFM_RescanStats& a_stats);
+
+    /// Pick up current path once expanded in background. Adopt the latest
+    /// snapshot and move current path to the same directory, or its nearest
+    /// ancestor that still exists.
+    ///
+    /// @note
+    ///   Must be called from the thread that owns current path.
+    void Sync();
+
+    /// The snapshot adopted by current path.
+    const MFM_Snapshot& Snapshot() const noexcept { return *snapshot; }
+
+    MFM_NodeID CurrentPath() const noexcept { return currentPath; }
+
+    /// Set current path. A directory not expanded yet is expanded on pool,
+    /// and shows no children until Sync() picks it up, so that a cold
+    /// directory does not stall the frame.
+    void CurrentPath(MFM_NodeID a_id);
 
     const std::string& CurrentPathStr() const noexcept { return currentPathStr; }
 
-    void ResetCurrentPath() { CurrentPath(root); }
+    /// Increase whenever current path is set, including on adopting a new
+    /// snapshot, or its children are expanded.
+    std::uint32_t CurrentPathVersion() const noexcept { return currentPathVersion; }
+
+    /// Whether current path is being expanded in background.
+    [[nodiscard]] bool IsExpanding() const noexcept { return expanding; }
+
+    void ResetCurrentPath() { CurrentPath(MFM_Snapshot::root); }
+
+    void ResetCurrentPathToParent() { CurrentPath((*snapshot)[currentPath].parent); }
+
+    /// The function of a regular node. Parse it on first call, unless it is
+    /// already prefetched.
+    std::shared_ptr<const MFM_Function> Function(MFM_NodeID a_id);
+
+    /// Whether the function of a regular node is known to be unavailable.
+    /// Functions not resolved yet are assumed available.
+    [[nodiscard]] bool IsUnavailable(MFM_NodeID a_id) const noexcept { return snapshot->IsUnavailable(a_id); }
+
+    /// Expand the whole latest snapshot and index all its nodes for Search().
+    /// Later refreshes keep the index up to date incrementally.
+    void BuildSearch();
 
-    void ResetCurrentPathToParent() { CurrentPath(currentPath->parent); }
+    /// Find nodes whose display path contains all terms of query.
+    ///
+    /// @note
+    ///   Thread-safe. Return nothing until BuildSearch() finishes.
+    [[nodiscard]] std::vector<MFM_SearchResult> Search(std::string_view a_query, std::size_t a_limit);
+
+    /// Increase whenever search index changes.
+    [[nodiscard]] std::uint32_t SearchVersion() const noexcept { return _searchVersion.load(); }
+
+    /// Collect functions bound to hotkeys among the given paths of index
+    /// records, skipping those of other trees. Only these files are probed,
+    /// and parsed again if changed.
+    void CollectHotkeys(std::span<const std::string> a_paths, std::vector<MFM_HotkeyBinding>& a_out);
+
+    /// Increase whenever what is drawn from tree may change in background:
+    /// a snapshot is published, search index changes, or a prefetched entry
+    /// is ready.
+    [[nodiscard]] std::uint32_t ChangeVersion() const noexcept { return _changeVersion.load() + SearchVersion(); }
 
 private:
-    const MFM_Node  root;
-    const MFM_Node* currentPath;
-    std::string     currentPathStr;
+    /// Search index over display paths of all nodes, that is relative path
+    /// without ".toml".
+    struct SearchState
+    {
+        /// Index directory's descendants, which must have been expanded.
+        void AddSubtree(const MFM_Snapshot& a_snapshot, MFM_NodeID a_id);
+
+        /// Unindex descendants of a removed directory.
+        void RemoveSubtree(std::string_view a_relPath);
+
+        /// Merge children of an enumerated directory into index.
+        void Update(const MFM_Snapshot& a_snapshot, MFM_NodeID a_id);
+
+        /// The relative path of document.
+        [[nodiscard]] std::string Path(SearchIndex::DocID a_id) const;
+
+        SearchIndex                 index;
+        std::vector<MFM_Node::Type> types;  // By document.
+
+        // Documents of direct children, by relative path of directory.
+        std::map<std::string, std::vector<SearchIndex::DocID>, std::less<>> dirs;
+
+    private:
+        SearchIndex::DocID Add(const MFM_Snapshot& a_snapshot, MFM_NodeID a_id);
+    };
+
+    /// Expand subdirectories and parse functions of the given node in
+    /// background, so that navigating into them or clicking them does not
+    /// block on filesystem.
+    void Prefetch(MFM_NodeID a_id);
+
+    std::shared_ptr<const MFM_Snapshot>              snapshot;
+    std::atomic<std::shared_ptr<const MFM_Snapshot>> latest;
+    std::string                                      prefix;
+    MFM_NodeID                                       currentPath{ MFM_Snapshot::root };
+    std::string                                      currentPathStr;
+    std::uint32_t                                    currentPathVersion{ 0 };
+    bool                                             expanding{ false };
+    std::uint32_t                                    expandTicket{ 0 };  // Of the latest expansion submitted.
+
+    ThreadPool&                _pool;
+    MFM_FunctionCache          _functions;
+    std::mutex                 _refreshMutex;
+    std::atomic<std::uint32_t> _prefetchVersion{ 0 };
+    std::atomic<std::uint32_t> _expandedTicket{ 0 };  // Of the latest expansion finished.
+
+    mutable std::shared_mutex  _searchMutex;
+    SearchState                _search;
+    bool                       _searchReady{ false };  // Guarded by refresh mutex.
+    std::atomic<std::uint32_t> _searchVersion{ 0 };
+
+    std::atomic<std::uint32_t> _changeVersion{ 0 };
 };
 
 class Datastore final : public Singleton<Datastore>
@@ -94,12 +479,69 @@ public:
 
     void ResetCurrentSection() { CurrentSection(modTree); }
 
-    MFM_Tree  modTree{ MFM_Path::mod };
-    MFM_Tree  configTree{ MFM_Path::config };
-    MFM_Tree* currentSection;
+    /// Incrementally rescan both trees.
+    MFM_RescanStats Refresh();
+
+    /// Save index in background, and bind hotkeys of functions parsed since.
+    void SaveIndex();
+
+    /// Build search index of both trees in background, once, if enabled.
+    /// Called again after config reload, so that enabling search takes
+    /// effect without restart.
+    void BuildSearch();
+
+    /// Search both trees, ranked across them.
+    [[nodiscard]] std::vector<MFM_SearchResult> Search(std::string_view a_query, std::size_t a_limit);
+
+    /// Increase whenever search index of either tree changes.
+    [[nodiscard]] std::uint32_t SearchVersion() const noexcept
+    {
+        return modTree.SearchVersion() + configTree.SearchVersion();
+    }
+
+    /// Increase whenever either tree changes in background.
+    [[nodiscard]] std::uint32_t ChangeVersion() const noexcept
+    {
+        return modTree.ChangeVersion() + configTree.ChangeVersion();
+    }
+
+    /// Collect functions bound to hotkeys from both trees in background, and
+    /// publish them as a whole if changed. Do nothing if disabled.
+    ///
+    /// Hotkeys are known from records of parsed functions in index, so
+    /// neither tree is walked. A function is bound once its file has been
+    /// parsed, in this session or an earlier one.
+    void BuildHotkeys();
+
+    /// The functions bound to hotkeys, or nullptr until first built.
+    ///
+    /// @note
+    ///   Static, so that input thread never waits for datastore to be
+    ///   constructed.
+    [[nodiscard]] static std::shared_ptr<const std::vector<MFM_HotkeyBinding>> Hotkeys() noexcept
+    {
+        return _hotkeys.load();
+    }
+
+    /// Increase whenever functions bound to hotkeys are published.
+    [[nodiscard]] static std::uint32_t HotkeyVersion() noexcept { return _hotkeyVersion.load(); }
+
+    ThreadPool pool;  // Shared by trees for filesystem scanning.
+    MFM_Tree   modTree;
+    MFM_Tree   configTree;
+    MFM_Tree*  currentSection;
 
 private:
-    Datastore() { ResetCurrentSection(); };
+    Datastore();
 
     ~Datastore() = default;
+
+    /// Poll filesystem and refresh periodically, if enabled.
+    [[noreturn]] void Watch();
+
+    std::mutex        _hotkeyMutex;  // Serialize publishing.
+    std::atomic<bool> _searchStarted{ false };
+
+    static inline std::atomic<std::shared_ptr<const std::vector<MFM_HotkeyBinding>>> _hotkeys;
+    static inline std::atomic<std::uint32_t>                                         _hotkeyVersion{ 0 };
 };
@@ -0,0 +1,59 @@
+#include "Executor.h"
+
+Executor::Executor()
+{
+    std::thread t{ [this]() { Run(); } };
+    t.detach();
+}
+
+Executor::JobID Executor::Submit(std::shared_ptr<const MFM_Function> a_func)
+{
+    JobID id;
+    {
+        std::scoped_lock lock{ _mutex };
+        id = _nextID++;
+        _jobs.push_back({ id, std::move(a_func) });
+    }
+    _cond.notify_one();
+    return id;
+}
+
+void Executor::CancelPending()
+{
+    std::scoped_lock lock{ _mutex };
+    for (auto& job : _jobs) {
+        SKSE::log::debug("Cancel function: dll = \"{}\", api = \"{}\".", job.func->dll, job.func->api);
+        _completions.push_back({ job.id, std::move(job.func), {}, {}, true });
+    }
+    _jobs.clear();
+}
+
+std::vector<Executor::Completion> Executor::Drain()
+{
+    std::scoped_lock lock{ _mutex };
+    return std::exchange(_completions, {});
+}
+
+void Executor::Run()
+{
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock lock{ _mutex };
+            _cond.wait(lock, [this]() { return !_jobs.empty(); });
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        Completion completion{ job.id, job.func, {}, {}, false };
+        try {
+            SKSE::log::debug("Invoke {} function on worker.", MFMAPI_Type_EnumToStr(job.func->type));
+            completion.msg = job.func->Invoke();
+        } catch (const std::exception& e) {
+            completion.error = e.what();
+        }
+
+        std::scoped_lock lock{ _mutex };
+        _completions.push_back(std::move(completion));
+    }
+}
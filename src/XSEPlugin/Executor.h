@@ -0,0 +1,55 @@
+#pragma once
+
+#include <XSEPlugin/Core.h>
+#include <XSEPlugin/Util/Singleton.h>
+
+/// Invoke worker mod functions on a dedicated thread, and post completions
+/// back for render thread to drain.
+///
+/// @note
+///   Thread-safe.
+class Executor final : public Singleton<Executor>
+{
+    friend class Singleton<Executor>;
+
+public:
+    using JobID = std::uint64_t;
+
+    struct Completion
+    {
+        JobID                               id;
+        std::shared_ptr<const MFM_Function> func;
+        std::string                         msg;        // Message written by function, if any.
+        std::string                         error;      // Exception message, if function failed.
+        bool                                cancelled;  // Dequeued before running.
+    };
+
+    /// Queue function to run on worker thread.
+    JobID Submit(std::shared_ptr<const MFM_Function> a_func);
+
+    /// Cancel queued functions that have not started. Their completions are
+    /// still posted, marked as cancelled.
+    void CancelPending();
+
+    /// Take all posted completions.
+    [[nodiscard]] std::vector<Completion> Drain();
+
+private:
+    struct Job
+    {
+        JobID                               id;
+        std::shared_ptr<const MFM_Function> func;
+    };
+
+    Executor();
+
+    ~Executor() = default;
+
+    [[noreturn]] void Run();
+
+    std::mutex              _mutex;
+    std::condition_variable _cond;
+    std::deque<Job>         _jobs;
+    std::vector<Completion> _completions;
+    JobID                   _nextID{ 1 };
+};
@@ -4,9 +4,20 @@
 
 #include <XSEPlugin/Base/Configuration.h>
 #include <XSEPlugin/Base/Translation.h>
+#include <XSEPlugin/Core.h>
+#include <XSEPlugin/ImGui/Renderer.h>
+#include <XSEPlugin/InputRecorder.h>
 
 MFMAPI void ReloadConfig(char* a_msg, std::size_t a_len)
 {
+    // Serialize reloads only. Readers keep using the previous snapshot meanwhile.
+    // Configuration and Translation are published one after the other, so a
+    // reader may pair the new one with the old other. Renderer, which loads
+    // fonts from both, reads versions before snapshots and loads again on the
+    // next frame, so a mixed pair is drawn for one frame at most.
+    static std::mutex reloadMutex;
+    std::scoped_lock  reloadLock{ reloadMutex };
+
     std::ostringstream oss;
     {
         auto logger = spdlog::create<spdlog::sinks::ostream_sink_mt>("Base", oss);
@@ -15,19 +26,16 @@ MFMAPI void ReloadConfig(char* a_msg, std::size_t a_len)
         logger->flush_on(spdlog::level::info);
     }
 
-    {
-        std::scoped_lock lock{ Configuration::Mutex(), Translation::Mutex() };
-        try {
-            Configuration::Init(false);
-            Translation::Init(false);
+    try {
+        Configuration::Init(false);
+        Translation::Init(false);
 
-            ReconfigureLogger(Configuration::GetSingleton()->general.sLogLevel);
+        ReconfigureLogger(Configuration::GetSingleton()->general.sLogLevel);
 
-            Configuration::IncrementVersion();
-            Translation::IncrementVersion();
-        } catch (...) {
-            // Suppress exception.
-        }
+        // Search may have been enabled.
+        Datastore::GetSingleton()->BuildSearch();
+    } catch (...) {
+        // Suppress exception.
     }
 
     if (a_msg) {
@@ -37,3 +45,72 @@ MFMAPI void ReloadConfig(char* a_msg, std::size_t a_len)
 
     spdlog::drop("Base");
 }
+
+MFMAPI void RefreshTree(char* a_msg, std::size_t a_len)
+{
+    auto stats = Datastore::GetSingleton()->Refresh();
+
+    if (a_msg) {
+        auto msg = std::format("Visited {} directories, rescanned {} directories.", stats.visited, stats.rescanned);
+        std::memcpy(a_msg, msg.c_str(), std::min(msg.size() + 1, a_len));
+    }
+}
+
+MFMAPI void FrameStats(MFMAPI_Writer* a_writer, MFMAPI_WriteFunc a_write)
+{
+    auto report = ImGui::Renderer::GetSingleton()->frameStats.Report();
+    a_write(a_writer, report.data(), report.size());
+}
+
+MFMAPI void InputLatency(MFMAPI_Writer* a_writer, MFMAPI_WriteFunc a_write)
+{
+    auto report = ImGui::Renderer::GetSingleton()->frameStats.ReportLatency();
+    a_write(a_writer, report.data(), report.size());
+}
+
+MFMAPI void ExportFrameStats(char* a_msg, std::size_t a_len)
+{
+    std::string msg;
+    if (auto path = SKSE::log::log_directory()) {
+        *path /= "ccld_ModFunctionMenu_FrameStats.json"sv;
+        try {
+            std::ofstream file{ *path, std::ios::binary | std::ios::trunc };
+            file.exceptions(std::ios::failbit | std::ios::badbit);
+            file << ImGui::Renderer::GetSingleton()->frameStats.ReportJSON();
+            msg = std::format("Exported frame stats to \"{}\".", PathToStr(*path));
+        } catch (const std::system_error& e) {
+            msg = std::format("Failed to export frame stats to \"{}\": {}.", PathToStr(*path),
+                SKSE::stl::ansi_to_utf8(e.what()).value_or(e.what()));
+        }
+    } else {
+        msg = "Failed to find SKSE logging directory."s;
+    }
+
+    if (a_msg) {
+        std::memcpy(a_msg, msg.c_str(), std::min(msg.size() + 1, a_len));
+    }
+}
+
+MFMAPI void RecordInput(char* a_msg, std::size_t a_len)
+{
+    std::string msg;
+    if (InputRecorder::IsRecording()) {
+        msg = InputRecorder::StopRecording();
+    } else {
+        InputRecorder::StartRecording();
+        msg = "Recording input. Invoke again to stop and save."s;
+    }
+
+    if (a_msg) {
+        std::memcpy(a_msg, msg.c_str(), std::min(msg.size() + 1, a_len));
+    }
+}
+
+MFMAPI void ReplayInput(char* a_msg, std::size_t a_len)
+{
+    auto msg = InputRecorder::IsReplaying() ? InputRecorder::StopReplay() : InputRecorder::StartReplay();
+
+    if (a_msg) {
+        std::memcpy(a_msg, msg.c_str(), std::min(msg.size() + 1, a_len));
+    }
+}
@@ -18,6 +18,7 @@ enum class MFMAPI_Type : std::uint32_t
     kVoid = 0,
     kMessage = 1,
     kMessageBox = 2,
+    kStreamBox = 3,
 };
 
 inline MFMAPI_Type MFMAPI_Type_StrToEnum(std::string_view a_str)
@@ -30,6 +31,8 @@ inline MFMAPI_Type MFMAPI_Type_StrToEnum(std::string_view a_str)
         return MFMAPI_Type::kMessage;
     } else if (a_str == "MessageBox"sv) {
         return MFMAPI_Type::kMessageBox;
+    } else if (a_str == "StreamBox"sv) {
+        return MFMAPI_Type::kStreamBox;
     } else {
         return MFMAPI_Type::kVoid;
     }
@@ -46,6 +49,8 @@ inline std::string MFMAPI_Type_EnumToStr(MFMAPI_Type a_enum)
         return "Message"s;
     case MFMAPI_Type::kMessageBox:
         return "MessageBox"s;
+    case MFMAPI_Type::kStreamBox:
+        return "StreamBox"s;
     default:
         return "Void"s;
     }
@@ -58,6 +63,14 @@ extern "C"
     using MFMAPI_Message = void (*)(char* a_msg, std::size_t a_len);
     // Copy your message to `a_msg` buffer with `a_len` length.
     using MFMAPI_MessageBox = MFMAPI_Message;
+
+    // Opaque handle to a message buffer owned by MFM.
+    struct MFMAPI_Writer;
+    // Append `a_len` bytes of `a_data` to the message of `a_writer`.
+    using MFMAPI_WriteFunc = void (*)(MFMAPI_Writer* a_writer, const char* a_data, std::size_t a_len);
+    // Write your message of any length by calling `a_write` with `a_writer`,
+    // as many times as needed. Both are valid only until you return.
+    using MFMAPI_StreamBox = void (*)(MFMAPI_Writer* a_writer, MFMAPI_WriteFunc a_write);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,3 +156,42 @@ inline std::string MFMAPI_PostAction_EnumToStr(MFMAPI_PostAction a_enum)
         return "None"s;
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// MFMAPI_Thread
+//
+// The thread to invoke a mod function on.
+enum class MFMAPI_Thread : std::uint32_t
+{
+    // Render thread, which blocks game until function returns.
+    kRender = 0,
+    // A dedicated worker thread. Function must be thread-safe.
+    kWorker = 1,
+};
+
+inline MFMAPI_Thread MFMAPI_Thread_StrToEnum(std::string_view a_str)
+{
+    using namespace std::literals::string_view_literals;
+
+    if (a_str.empty() || a_str == "Render"sv) {
+        return MFMAPI_Thread::kRender;
+    } else if (a_str == "Worker"sv) {
+        return MFMAPI_Thread::kWorker;
+    } else {
+        return MFMAPI_Thread::kRender;
+    }
+}
+
+inline std::string MFMAPI_Thread_EnumToStr(MFMAPI_Thread a_enum)
+{
+    using namespace std::literals::string_literals;
+
+    switch (a_enum) {
+    case MFMAPI_Thread::kRender:
+        return "Render"s;
+    case MFMAPI_Thread::kWorker:
+        return "Worker"s;
+    default:
+        return "Render"s;
+    }
+}
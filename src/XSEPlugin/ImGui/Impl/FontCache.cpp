@@ -0,0 +1,232 @@
+#include "FontCache.h"
+
+#include <imgui_internal.h>
+
+#include <XSEPlugin/Util/Binary.h>
+#include <XSEPlugin/Util/Win.h>
+
+namespace ImGui::Impl
+{
+    namespace
+    {
+        /// 64-bit FNV-1a hash.
+        class Hasher
+        {
+        public:
+            void Add(const void* a_data, std::size_t a_size) noexcept
+            {
+                auto bytes = static_cast<const unsigned char*>(a_data);
+                for (std::size_t i = 0; i < a_size; ++i) {
+                    _value = (_value ^ bytes[i]) * 0x100000001B3;
+                }
+            }
+
+            template <class T>
+                requires(std::is_trivially_copyable_v<T>)
+            void Add(const T& a_value) noexcept
+            {
+                Add(std::addressof(a_value), sizeof(T));
+            }
+
+            void Add(std::string_view a_str) noexcept
+            {
+                Add(a_str.size());
+                Add(a_str.data(), a_str.size());
+            }
+
+            [[nodiscard]] std::uint64_t value() const noexcept { return _value; }
+
+        private:
+            std::uint64_t _value{ 0xCBF29CE484222325 };
+        };
+    }
+
+    std::uint64_t FontCache::Key(const ImFontAtlas* a_atlas, const std::string& a_fontPath)
+    {
+        Hasher hasher;
+        hasher.Add(version);
+        hasher.Add(IMGUI_VERSION_NUM);
+
+        // Font file, which may be replaced in place.
+        hasher.Add(std::string_view{ a_fontPath });
+        std::error_code ec;
+        auto            path = StrToPath(a_fontPath);
+        hasher.Add(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+        hasher.Add(std::filesystem::file_size(path, ec));
+
+        hasher.Add(a_atlas->Flags);
+        hasher.Add(a_atlas->TexDesiredWidth);
+        hasher.Add(a_atlas->TexGlyphPadding);
+        hasher.Add(a_atlas->FontBuilderFlags);
+
+        for (const auto& cfg : a_atlas->ConfigData) {
+            hasher.Add(cfg.FontNo);
+            hasher.Add(cfg.SizePixels);
+            hasher.Add(cfg.OversampleH);
+            hasher.Add(cfg.OversampleV);
+            hasher.Add(cfg.PixelSnapH);
+            hasher.Add(cfg.GlyphExtraSpacing);
+            hasher.Add(cfg.GlyphOffset);
+            hasher.Add(cfg.GlyphMinAdvanceX);
+            hasher.Add(cfg.GlyphMaxAdvanceX);
+            hasher.Add(cfg.MergeMode);
+            hasher.Add(cfg.FontBuilderFlags);
+            hasher.Add(cfg.RasterizerMultiply);
+            hasher.Add(cfg.RasterizerDensity);
+            hasher.Add(cfg.EllipsisChar);
+        }
+
+        // Custom rects change packing.
+        for (const auto& rect : a_atlas->CustomRects) {
+            hasher.Add(rect.Width);
+            hasher.Add(rect.Height);
+        }
+
+        return hasher.value();
+    }
+
+    bool FontCache::Load(ImFontAtlas* a_atlas, std::uint64_t a_key, ImFontGlyphRangesBuilder& a_ranges)
+    {
+        if (a_atlas->Fonts.Size != 1 || a_atlas->ConfigData.Size != 1) {
+            return false;
+        }
+
+        Win::MappedFile file;
+        if (!file.Open(_path.c_str())) {
+            SKSE::log::debug("Font cache \"{}\" is not available.", PathToStr(_path));
+            return false;
+        }
+
+        auto data = file.data();
+
+        std::size_t offset = 0;
+        auto        header = Binary::Take<Header>(data, offset, 1);
+        if (!header || header->front().magic != magic || header->front().version != version) {
+            SKSE::log::warn("Ignore font cache \"{}\": unknown format.", PathToStr(_path));
+            return false;
+        }
+
+        const auto& h = header->front();
+        if (h.key != a_key) {
+            SKSE::log::debug("Ignore font cache \"{}\": font or config changed.", PathToStr(_path));
+            return false;
+        }
+        if (h.texWidth == 0 || h.texWidth > 0x8000 || h.texHeight == 0 || h.texHeight > 0x8000) {
+            SKSE::log::warn("Ignore font cache \"{}\": bad texture size.", PathToStr(_path));
+            return false;
+        }
+
+        auto rects = Binary::Take<RectRecord>(data, offset, h.rectCount);
+        auto glyphs = Binary::Take<ImFontGlyph>(data, offset, h.glyphCount);
+        auto ranges = Binary::Take<ImWchar>(data, offset, h.rangeCount);
+        auto pixels = Binary::Take<unsigned char>(data, offset, h.texWidth * h.texHeight);
+        if (!rects || !glyphs || !ranges || !pixels) {
+            SKSE::log::warn("Ignore font cache \"{}\": truncated.", PathToStr(_path));
+            return false;
+        }
+        if (ranges->empty() || ranges->size() % 2 != 1 || ranges->back() != 0) {
+            SKSE::log::warn("Ignore font cache \"{}\": bad glyph ranges.", PathToStr(_path));
+            return false;
+        }
+
+        ImFontGlyphRangesBuilder covered;
+        covered.AddRanges(ranges->data());
+        for (int i = 0; i < a_ranges.UsedChars.Size; ++i) {
+            if ((a_ranges.UsedChars[i] & ~covered.UsedChars[i]) != 0) {
+                SKSE::log::debug("Ignore font cache \"{}\": new characters.", PathToStr(_path));
+                return false;
+            }
+        }
+
+        // Register default rects, as the builder does first.
+        ImFontAtlasBuildInit(a_atlas);
+        if (static_cast<std::uint32_t>(a_atlas->CustomRects.Size) != h.rectCount) {
+            SKSE::log::warn("Ignore font cache \"{}\": custom rects changed.", PathToStr(_path));
+            return false;
+        }
+
+        a_atlas->TexID = nullptr;
+        a_atlas->ClearTexData();
+        a_atlas->TexWidth = static_cast<int>(h.texWidth);
+        a_atlas->TexHeight = static_cast<int>(h.texHeight);
+        a_atlas->TexUvScale = ImVec2{ 1.0f / static_cast<float>(h.texWidth), 1.0f / static_cast<float>(h.texHeight) };
+        a_atlas->TexUvWhitePixel = ImVec2{ 0.0f, 0.0f };
+        a_atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels->size()));
+        std::memcpy(a_atlas->TexPixelsAlpha8, pixels->data(), pixels->size());
+
+        for (int i = 0; i < a_atlas->CustomRects.Size; ++i) {
+            a_atlas->CustomRects[i].X = (*rects)[i].x;
+            a_atlas->CustomRects[i].Y = (*rects)[i].y;
+        }
+
+        auto font = a_atlas->Fonts[0];
+        ImFontAtlasBuildSetupFont(a_atlas, font, std::addressof(a_atlas->ConfigData[0]), h.ascent, h.descent);
+        font->Glyphs.resize(static_cast<int>(glyphs->size()));
+        std::memcpy(font->Glyphs.Data, glyphs->data(), glyphs->size_bytes());
+        font->DirtyLookupTables = true;
+
+        // Render default texture data, and build lookup tables.
+        ImFontAtlasBuildFinish(a_atlas);
+
+        for (int i = 0; i < a_ranges.UsedChars.Size; ++i) {
+            a_ranges.UsedChars[i] |= covered.UsedChars[i];
+        }
+
+        SKSE::log::debug("Load font cache \"{}\": {} glyphs.", PathToStr(_path), glyphs->size());
+        return true;
+    }
+
+    void FontCache::Save(const ImFontAtlas* a_atlas, std::uint64_t a_key, const ImVector<ImWchar>& a_ranges)
+    {
+        // Colored atlas has no alpha pixels.
+        if (a_atlas->Fonts.Size != 1 || !a_atlas->TexPixelsAlpha8 || a_ranges.empty()) {
+            return;
+        }
+
+        const auto& glyphs = a_atlas->Fonts[0]->Glyphs;
+
+        std::vector<RectRecord> rects;
+        rects.reserve(a_atlas->CustomRects.Size);
+        for (const auto& rect : a_atlas->CustomRects) {
+            rects.push_back({ rect.X, rect.Y });
+        }
+
+        Header header{};
+        header.magic = magic;
+        header.version = version;
+        header.key = a_key;
+        header.texWidth = static_cast<std::uint32_t>(a_atlas->TexWidth);
+        header.texHeight = static_cast<std::uint32_t>(a_atlas->TexHeight);
+        header.rectCount = static_cast<std::uint32_t>(rects.size());
+        header.glyphCount = static_cast<std::uint32_t>(glyphs.Size);
+        header.rangeCount = static_cast<std::uint32_t>(a_ranges.Size);
+        header.ascent = a_atlas->Fonts[0]->Ascent;
+        header.descent = a_atlas->Fonts[0]->Descent;
+
+        auto tmpPath = _path;
+        tmpPath += L".tmp"sv;
+
+        try {
+            {
+                std::ofstream file{ tmpPath, std::ios::binary | std::ios::trunc };
+                file.exceptions(std::ios::failbit | std::ios::badbit);
+
+                std::size_t offset = 0;
+                Binary::Put(file, offset, std::span<const Header>{ &header, 1 });
+                Binary::Put(file, offset, std::span<const RectRecord>{ rects });
+                Binary::Put(file, offset, std::span<const ImFontGlyph>{ glyphs.Data, glyphs.Data + glyphs.Size });
+                Binary::Put(file, offset, std::span<const ImWchar>{ a_ranges.Data, a_ranges.Data + a_ranges.Size });
+                Binary::Put(file, offset,
+                    std::span<const unsigned char>{ a_atlas->TexPixelsAlpha8,
+                        static_cast<std::size_t>(a_atlas->TexWidth) * a_atlas->TexHeight });
+            }
+            std::filesystem::rename(tmpPath, _path);
+            SKSE::log::debug("Successfully saved font cache to \"{}\".", PathToStr(_path));
+        } catch (const std::system_error& e) {
+            SKSE::log::warn("Failed to save font cache to \"{}\": {}.", PathToStr(_path),
+                SKSE::stl::ansi_to_utf8(e.what()).value_or(e.what()));
+        } catch (const std::exception& e) {
+            SKSE::log::warn("Failed to save font cache to \"{}\": {}.", PathToStr(_path), e.what());
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <imgui.h>
+
+namespace ImGui::Impl
+{
+    /// A persistent cache of the built font atlas, so that startup and config
+    /// reload do not rasterize glyphs again.
+    ///
+    /// The cache holds atlas pixels, custom rect positions and glyph metrics
+    /// of the last atlas built from font file. It is keyed by a hash of font
+    /// file and every setting that affects the atlas, and also records the
+    /// set of characters it covers: it is used whenever that set includes all
+    /// characters requested.
+    ///
+    /// It is saved only when an atlas is built. Glyphs grown into reserved
+    /// space afterwards are not saved, so they are grown again next session,
+    /// unless a later rebuild takes them into a saved atlas.
+    class FontCache
+    {
+    public:
+        /// The key of atlas whose single font is added but not built yet.
+        [[nodiscard]] static std::uint64_t Key(const ImFontAtlas* a_atlas, const std::string& a_fontPath);
+
+        /// Restore atlas from cache file, if its key matches and it covers all
+        /// characters of the given ranges. On success, the characters it
+        /// covers are added to the ranges.
+        ///
+        /// @return
+        ///   False if atlas must be built.
+        static bool Load(ImFontAtlas* a_atlas, std::uint64_t a_key, ImFontGlyphRangesBuilder& a_ranges);
+
+        /// Write built atlas to cache file, replacing the previous one.
+        static void Save(const ImFontAtlas* a_atlas, std::uint64_t a_key, const ImVector<ImWchar>& a_ranges);
+
+    private:
+        struct Header
+        {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint64_t key;
+            std::uint32_t texWidth;
+            std::uint32_t texHeight;
+            std::uint32_t rectCount;
+            std::uint32_t glyphCount;
+            std::uint32_t rangeCount;  // The number of ImWchar, including terminator.
+            float         ascent;
+            float         descent;
+            std::uint32_t reserved;
+        };
+
+        struct RectRecord
+        {
+            std::uint16_t x;
+            std::uint16_t y;
+        };
+
+        static constexpr std::uint32_t magic = 0x464D464D;  // "MFMF"
+        static constexpr std::uint32_t version = 1;
+
+        static inline const std::filesystem::path _path{ L"Data/SKSE/Plugins/ccld_ModFunctionMenu.fontcache"sv };
+    };
+}
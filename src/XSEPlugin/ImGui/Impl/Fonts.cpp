@@ -1,17 +1,27 @@
 #include "Fonts.h"
 
+#include <d3d11.h>
+
 #include <imgui_impl_dx11.h>
 #include <imgui_impl_win32.h>
 #include <imgui_internal.h>
 
 #include <XSEPlugin/Base/Configuration.h>
 #include <XSEPlugin/Base/Translation.h>
+#include <XSEPlugin/ImGui/Impl/FontCache.h>
+#include <XSEPlugin/Util/UTF8.h>
 
 namespace ImGui::Impl
 {
-    void Fonts::Load()
+    namespace
     {
-        auto& cfgFonts = Configuration::GetSingleton()->fonts;
+        // Free space of atlas, in glyphs of font size.
+        constexpr int kReservedGlyphs = 512;
+    }
+
+    void Fonts::Load(const Configuration& a_config, const Translation& a_trans)
+    {
+        const auto& cfgFonts = a_config.fonts;
 
         _path = cfgFonts.general.sFont;
         _size = cfgFonts.general.fSize;
@@ -19,11 +29,13 @@ namespace ImGui::Impl
         _config = ImFontConfig();
         _rangesBuilder = ImFontGlyphRangesBuilder();
 
+        _pending.clear();
         _wantRefresh = false;
+        ++_version;
 
         // Feed default glyph ranges.
         _rangesBuilder.AddRanges(ImGui::GetIO().Fonts->GetGlyphRangesDefault());
-        Translation::GetSingleton()->Visit(  //
+        a_trans.Visit(  //
             [this]([[maybe_unused]] const std::string& key, const std::string& value) {
                 _rangesBuilder.AddText(value.c_str());
             });
@@ -33,6 +45,10 @@ namespace ImGui::Impl
 
     void Fonts::Feed(std::string_view a_text)
     {
+        if (UTF8::IsASCII(a_text)) {
+            return;
+        }
+
         auto text = a_text.data();
         auto text_end = text + a_text.size();
         while (text < text_end) {
@@ -45,35 +61,197 @@ namespace ImGui::Impl
 
             if (!_rangesBuilder.GetBit(c)) {
                 _rangesBuilder.SetBit(c);
+                _pending.push_back(static_cast<ImWchar>(c));
                 _wantRefresh = true;
             }
         }
     }
 
-    void Fonts::Refresh()
+    bool Fonts::Refresh()
     {
+        if (Swap()) {
+            return true;
+        }
+
         if (!_wantRefresh) {
-            return;
+            return false;
         }
 
         _wantRefresh = false;
 
+        auto pending = std::exchange(_pending, {});
+        if (Grow(pending)) {
+            SKSE::log::trace("Grow font by {} glyphs.", pending.size());
+            return true;
+        }
+
         Rebuild();
-        SKSE::log::trace("Refresh font.");
+        SKSE::log::trace("Refresh font in background.");
+        return false;
     }
 
-    void Fonts::Rebuild()
+    std::unique_ptr<Fonts::Build> Fonts::Make(
+        std::string a_path, float a_size, ImFontConfig a_config, ImFontGlyphRangesBuilder a_ranges)
     {
-        auto& io = ImGui::GetIO();
-        io.Fonts->Clear();
+        auto build = std::make_unique<Build>();
+        build->atlas = std::make_unique<ImFontAtlas>();
+        build->glyphAtlas = std::make_unique<GlyphAtlas>();
+        build->ranges = std::move(a_ranges);
+
+        auto atlas = build->atlas.get();
 
         ImVector<ImWchar> ranges;
-        _rangesBuilder.BuildRanges(&ranges);
+        build->ranges.BuildRanges(&ranges);
+
+        atlas->AddFontFromFileTTF(a_path.c_str(), a_size, &a_config, ranges.Data);
+        build->glyphAtlas->Reserve(atlas, a_size, kReservedGlyphs);
+
+        // Rasterize only if cache does not cover all characters.
+        auto key = FontCache::Key(atlas, a_path);
+        if (!FontCache::Load(atlas, key, build->ranges)) {
+            atlas->Build();
+            FontCache::Save(atlas, key, ranges);
+        }
+
+        if (!build->glyphAtlas->Attach(atlas)) {
+            SKSE::log::warn("Failed to reserve glyph space; every new glyph rebuilds font.");
+        }
+
+        // Convert pixels here, so that render thread only uploads them.
+        unsigned char* pixels = nullptr;
+        int            width = 0;
+        int            height = 0;
+        atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+        return build;
+    }
+
+    void Fonts::Rebuild()
+    {
+        if (_building.valid()) {
+            // Start again from the latest state once the current one is done.
+            _wantRebuild = true;
+            return;
+        }
+
+        _pending.clear();
+        _wantRefresh = false;
+        _building = std::async(std::launch::async, Make, _path, _size, _config, _rangesBuilder);
+
+        if (!_atlas) {
+            // Nothing to draw with yet.
+            _building.wait();
+            Swap();
+        }
+    }
+
+    bool Fonts::Swap()
+    {
+        using namespace std::chrono_literals;
 
-        io.Fonts->AddFontFromFileTTF(_path.c_str(), _size, &_config, ranges.Data);
-        io.Fonts->Build();
+        if (!_building.valid() || _building.wait_for(0s) != std::future_status::ready) {
+            return false;
+        }
+
+        std::unique_ptr<Build> build;
+        try {
+            build = _building.get();
+        } catch (const std::exception& e) {
+            // Keep drawing with the current atlas.
+            SKSE::log::error("Failed to build font \"{}\": {}.", _path, e.what());
+            return false;
+        }
+        if (!build) {
+            return false;
+        }
+
+        // Characters fed while building, which the new atlas lacks.
+        std::vector<ImWchar> missing;
+        for (int i = 0; i < _rangesBuilder.UsedChars.Size; ++i) {
+            auto bits = _rangesBuilder.UsedChars[i] & ~build->ranges.UsedChars[i];
+            for (int bit = 0; bits != 0; ++bit, bits >>= 1) {
+                if (bits & 1) {
+                    missing.push_back(static_cast<ImWchar>(i * 32 + bit));
+                }
+            }
+            _rangesBuilder.UsedChars[i] |= build->ranges.UsedChars[i];
+        }
+
+        // Free the default atlas of context, which it would otherwise delete
+        // in place of ours on destruction.
+        if (auto& g = *ImGui::GetCurrentContext(); g.FontAtlasOwnedByContext) {
+            IM_DELETE(g.IO.Fonts);
+            g.IO.Fonts = nullptr;
+            g.FontAtlasOwnedByContext = false;
+        }
+
+        // Fonts of the previous atlas are no longer referenced between frames.
+        _atlas = std::move(build->atlas);
+        _glyphAtlas = std::move(build->glyphAtlas);
+        ImGui::GetIO().Fonts = _atlas.get();
 
         ImGui_ImplDX11_InvalidateDeviceObjects();
         ImGui_ImplDX11_CreateDeviceObjects();
+
+        // Missing glyphs are drawn as fallback until they are grown.
+        _pending.clear();
+        _wantRefresh = false;
+        if (std::exchange(_wantRebuild, false) || !Grow(missing)) {
+            Rebuild();
+        }
+
+        SKSE::log::trace("Swap in font built in background, {} glyphs missing.", missing.size());
+        return true;
+    }
+
+    bool Fonts::Grow(std::span<const ImWchar> a_codepoints)
+    {
+        if (a_codepoints.empty()) {
+            return true;
+        }
+        if (!_glyphAtlas || !_glyphAtlas->IsAttached()) {
+            return false;
+        }
+
+        for (auto c : a_codepoints) {
+            if (!_glyphAtlas->AddGlyph(c)) {
+                // Atlas is full. Glyphs added so far are discarded by rebuild.
+                return false;
+            }
+        }
+        _glyphAtlas->Commit();
+
+        Upload(_glyphAtlas->TakeDirty());
+        return true;
+    }
+
+    void Fonts::Upload(const GlyphAtlas::Rect& a_rect)
+    {
+        if (a_rect.x0 == a_rect.x1 || a_rect.y0 == a_rect.y1) {
+            return;
+        }
+
+        auto  fonts = ImGui::GetIO().Fonts;
+        auto* view = static_cast<ID3D11ShaderResourceView*>(fonts->TexID);
+        if (!view || !fonts->TexPixelsRGBA32) {
+            return;
+        }
+
+        ID3D11Resource* texture = nullptr;
+        view->GetResource(&texture);
+        ID3D11Device* device = nullptr;
+        texture->GetDevice(&device);
+        ID3D11DeviceContext* context = nullptr;
+        device->GetImmediateContext(&context);
+
+        D3D11_BOX box{ static_cast<UINT>(a_rect.x0), static_cast<UINT>(a_rect.y0), 0, static_cast<UINT>(a_rect.x1),
+            static_cast<UINT>(a_rect.y1), 1 };
+        auto pitch = static_cast<UINT>(fonts->TexWidth) * 4;
+        auto pixels = fonts->TexPixelsRGBA32 + static_cast<std::size_t>(a_rect.y0) * fonts->TexWidth + a_rect.x0;
+        context->UpdateSubresource(texture, 0, &box, pixels, pitch, 0);
+
+        context->Release();
+        device->Release();
+        texture->Release();
     }
 }
@@ -2,34 +2,85 @@
 
 #include <imgui.h>
 
+#include <XSEPlugin/Base/Configuration.h>
+#include <XSEPlugin/Base/Translation.h>
+#include <XSEPlugin/ImGui/Impl/GlyphAtlas.h>
+
 namespace ImGui::Impl
 {
     class Fonts
     {
     public:
-        /// Fetch and apply the latest fonts.
-        ///
-        /// @note
-        ///   Assume caller has already acquired shared lock of
-        ///   configuration and translation before calling.
-        void Load();
+        /// Apply fonts of the given snapshots.
+        void Load(const Configuration& a_config, const Translation& a_trans);
 
-        /// Update glyph ranges.
+        /// Update glyph ranges. ASCII text returns at once, as it is always
+        /// covered by default ranges.
         void Feed(std::string_view a_text);
 
-        /// Rebuild fonts if glyph ranges change.
-        void Refresh();
+        /// Increase whenever glyph ranges are reset, so that text fed once
+        /// must be fed again.
+        [[nodiscard]] std::uint32_t Version() const noexcept { return _version; }
+
+        /// Swap in the atlas built in background if it is ready, then add
+        /// glyphs fed since last call. Rebuild fonts only if they do not fit
+        /// in free space of atlas.
+        ///
+        /// @return
+        ///   True if glyphs or atlas changed, so that frame must be built again.
+        ///
+        /// @note
+        ///   Must be called between frames.
+        bool Refresh();
 
     private:
-        /// Rebuild fonts from current config and glyph ranges.
+        /// An atlas built on worker thread, along with the glyph ranges it
+        /// was built from.
+        struct Build
+        {
+            std::unique_ptr<ImFontAtlas> atlas;
+            std::unique_ptr<GlyphAtlas>  glyphAtlas;
+            ImFontGlyphRangesBuilder     ranges;
+        };
+
+        /// Build atlas from the given config and glyph ranges. Touch no
+        /// state of ImGui context, so that it is safe to run on any thread.
+        [[nodiscard]] static std::unique_ptr<Build> Make(
+            std::string a_path, float a_size, ImFontConfig a_config, ImFontGlyphRangesBuilder a_ranges);
+
+        /// Start rebuilding fonts from current config and glyph ranges in
+        /// background. The current atlas is kept until the new one is ready.
         void Rebuild();
 
+        /// Replace the current atlas with the built one, if it is ready.
+        ///
+        /// @return
+        ///   True if atlas is swapped.
+        bool Swap();
+
+        /// Rasterize glyphs into free space of atlas, and upload the region
+        /// they occupy.
+        ///
+        /// @return
+        ///   False if atlas must be rebuilt.
+        bool Grow(std::span<const ImWchar> a_codepoints);
+
+        /// Upload a region of atlas pixels to its texture.
+        static void Upload(const GlyphAtlas::Rect& a_rect);
+
         std::string _path;
         float       _size;
 
         ImFontConfig             _config;
         ImFontGlyphRangesBuilder _rangesBuilder;
+        std::vector<ImWchar>     _pending;  // Fed since last refresh.
+
+        std::unique_ptr<ImFontAtlas>        _atlas;  // Owned by us, not by ImGui context.
+        std::unique_ptr<GlyphAtlas>         _glyphAtlas;
+        std::future<std::unique_ptr<Build>> _building;
 
-        bool _wantRefresh{ false };
+        bool          _wantRefresh{ false };
+        bool          _wantRebuild{ false };  // Requested while building.
+        std::uint32_t _version{ 0 };
     };
 }
@@ -0,0 +1,394 @@
+#include "FrameStats.h"
+
+#include <imgui.h>
+
+namespace ImGui::Impl
+{
+    namespace
+    {
+        // Upper bounds of histogram buckets of frame time, in microseconds.
+        constexpr std::array<std::uint32_t, 8> kBuckets{ 50, 100, 250, 500, 1000, 2500, 5000, 10000 };
+
+        // Upper bounds of histogram buckets of input latency, in microseconds.
+        constexpr std::array<std::uint32_t, 8> kLatencyBuckets{ 1000, 2000, 4000, 8000, 16667, 33333, 50000, 100000 };
+
+        constexpr std::size_t kBarWidth = 40;
+
+        [[nodiscard]] inline float Milliseconds(std::uint32_t a_us) noexcept
+        {
+            return static_cast<float>(a_us) / 1000.0f;
+        }
+
+        /// Append values as JSON array.
+        inline void AppendArray(std::string& a_out, const std::vector<std::uint32_t>& a_values)
+        {
+            a_out += '[';
+            for (std::size_t i = 0; i < a_values.size(); ++i) {
+                if (i > 0) {
+                    a_out += ',';
+                }
+                a_out += std::to_string(a_values[i]);
+            }
+            a_out += ']';
+        }
+
+        /// The value at the given percentile of values, which are reordered.
+        [[nodiscard]] inline std::uint32_t Percentile(std::vector<std::uint32_t>& a_values, std::size_t a_percent)
+        {
+            if (a_values.empty()) {
+                return 0;
+            }
+            auto nth = a_values.begin() + static_cast<std::ptrdiff_t>((a_values.size() - 1) * a_percent / 100);
+            std::nth_element(a_values.begin(), nth, a_values.end());
+            return *nth;
+        }
+
+        /// Append histogram of values over buckets of upper bounds.
+        template <std::size_t N>
+        inline void AppendHistogram(std::string& a_out, const std::vector<std::uint32_t>& a_values,
+            const std::array<std::uint32_t, N>& a_buckets)
+        {
+            std::array<std::size_t, N + 1> counts{};
+            for (auto value : a_values) {
+                auto it = std::ranges::upper_bound(a_buckets, value);
+                ++counts[static_cast<std::size_t>(it - a_buckets.begin())];
+            }
+            auto most = *std::ranges::max_element(counts);
+
+            auto out = std::back_inserter(a_out);
+            for (std::size_t i = 0; i < counts.size(); ++i) {
+                auto label = i < N ? std::format("< {:.2f}", Milliseconds(a_buckets[i])) :
+                                     std::format(">= {:.2f}", Milliseconds(a_buckets.back()));
+                auto bar = most > 0 ? counts[i] * kBarWidth / most : 0;
+                std::format_to(out, "{:>10} {:>5} {}\n", label, counts[i], std::string(bar, '#'));
+            }
+        }
+
+        /// Summarize values, which are reordered.
+        [[nodiscard]] inline FrameStats::Summary Summarize(std::vector<std::uint32_t>& a_values)
+        {
+            if (a_values.empty()) {
+                return { 0, 0, 0 };
+            }
+            auto max = *std::ranges::max_element(a_values);
+            auto p99 = Percentile(a_values, 99);
+            auto p50 = Percentile(a_values, 50);
+            return { p50, p99, max };
+        }
+    }
+
+    std::string_view FrameStats::PhaseName(Phase a_phase) noexcept
+    {
+        switch (a_phase) {
+        case Phase::kCompletions:
+            return "Completions"sv;
+        case Phase::kLoad:
+            return "Load"sv;
+        case Phase::kFonts:
+            return "Fonts"sv;
+        case Phase::kNewFrame:
+            return "NewFrame"sv;
+        case Phase::kDraw:
+            return "Draw"sv;
+        case Phase::kRender:
+            return "Render"sv;
+        case Phase::kRenderDrawData:
+            return "RenderDrawData"sv;
+        case Phase::kTotal:
+            return "Total"sv;
+        default:
+            return "Unknown"sv;
+        }
+    }
+
+    std::string_view FrameStats::MetricName(Metric a_metric) noexcept
+    {
+        switch (a_metric) {
+        case Metric::kVertices:
+            return "Vertices"sv;
+        case Metric::kAllocations:
+            return "Allocations"sv;
+        case Metric::kAllocBytes:
+            return "AllocBytes"sv;
+        default:
+            return "Unknown"sv;
+        }
+    }
+
+    std::array<FrameStats::Summary, FrameStats::phaseCount> FrameStats::Summarize() const
+    {
+        std::array<Summary, phaseCount> summaries{};
+        std::vector<std::uint32_t>      values;
+        for (std::size_t i = 0; i < phaseCount; ++i) {
+            Collect(static_cast<Phase>(i), values);
+            summaries[i] = ImGui::Impl::Summarize(values);
+        }
+        return summaries;
+    }
+
+    std::array<FrameStats::Summary, FrameStats::metricCount> FrameStats::SummarizeMetrics() const
+    {
+        std::array<Summary, metricCount> summaries{};
+        std::vector<std::uint32_t>       values;
+        for (std::size_t i = 0; i < metricCount; ++i) {
+            Collect(static_cast<Metric>(i), values);
+            summaries[i] = ImGui::Impl::Summarize(values);
+        }
+        return summaries;
+    }
+
+    FrameStats::Summary FrameStats::SummarizeLatency() const
+    {
+        std::vector<std::uint32_t> values;
+        CollectLatency(values);
+        return ImGui::Impl::Summarize(values);
+    }
+
+    std::string FrameStats::Report() const
+    {
+        if (!IsEnabled()) {
+            return "Frame stats are disabled. Set bFrameStats = true in [Renderer] section of configuration."s;
+        }
+
+        std::vector<std::uint32_t> totals;
+        Collect(Phase::kTotal, totals);
+        if (totals.empty()) {
+            return "No frame recorded yet."s;
+        }
+
+        std::string report;
+        auto        out = std::back_inserter(report);
+
+        std::format_to(out, "Last {} frames, in milliseconds.\n\n", totals.size());
+        std::format_to(out, "{:<16}{:>10}{:>10}{:>10}\n", "Phase", "p50", "p99", "max");
+        auto summaries = Summarize();
+        for (std::size_t i = 0; i < phaseCount; ++i) {
+            const auto& summary = summaries[i];
+            std::format_to(out, "{:<16}{:>10.3f}{:>10.3f}{:>10.3f}\n", PhaseName(static_cast<Phase>(i)),
+                Milliseconds(summary.p50), Milliseconds(summary.p99), Milliseconds(summary.max));
+        }
+
+        std::format_to(out, "\n{:<16}{:>10}{:>10}{:>10}\n", "Metric", "p50", "p99", "max");
+        auto metrics = SummarizeMetrics();
+        for (std::size_t i = 0; i < metricCount; ++i) {
+            const auto& summary = metrics[i];
+            std::format_to(out, "{:<16}{:>10}{:>10}{:>10}\n", MetricName(static_cast<Metric>(i)), summary.p50,
+                summary.p99, summary.max);
+        }
+
+        std::format_to(out, "\nIdle frames: {}, of which {} allocated {} times ({} bytes).\n",
+            _idleFrames.load(std::memory_order_relaxed), _idleAllocFrames.load(std::memory_order_relaxed),
+            _idleAllocs.load(std::memory_order_relaxed), _idleAllocBytes.load(std::memory_order_relaxed));
+
+        std::format_to(out, "\nTotal frame time:\n");
+        AppendHistogram(report, totals, kBuckets);
+
+        report += '\n';
+        report += ReportLatency();
+        return report;
+    }
+
+    std::string FrameStats::ReportLatency() const
+    {
+        if (!IsEnabled()) {
+            return "Frame stats are disabled. Set bFrameStats = true in [Renderer] section of configuration."s;
+        }
+
+        std::vector<std::uint32_t> latencies;
+        CollectLatency(latencies);
+        if (latencies.empty()) {
+            return "No input latency recorded yet."s;
+        }
+
+        std::string report;
+        auto        out = std::back_inserter(report);
+
+        // Summarizing reorders values, which does not matter to histogram.
+        auto summary = ImGui::Impl::Summarize(latencies);
+        std::format_to(out, "Input latency of last {} inputs, from input hook to drawn frame, in milliseconds.\n",
+            latencies.size());
+        std::format_to(out, "p50 = {:.3f}, p99 = {:.3f}, max = {:.3f}\n", Milliseconds(summary.p50),
+            Milliseconds(summary.p99), Milliseconds(summary.max));
+        AppendHistogram(report, latencies, kLatencyBuckets);
+        return report;
+    }
+
+    std::string FrameStats::ReportJSON() const
+    {
+        std::string report;
+        auto        out = std::back_inserter(report);
+
+        std::vector<std::uint32_t> values;
+        Collect(Phase::kTotal, values);
+        std::format_to(out, "{{\n  \"frames\": {},\n  \"unit\": \"us\",\n  \"phases\": {{\n", values.size());
+
+        auto summaries = Summarize();
+        for (std::size_t i = 0; i < phaseCount; ++i) {
+            const auto& summary = summaries[i];
+            Collect(static_cast<Phase>(i), values);
+            std::format_to(out, "    \"{}\": {{ \"p50\": {}, \"p99\": {}, \"max\": {}, \"samples\": ",
+                PhaseName(static_cast<Phase>(i)), summary.p50, summary.p99, summary.max);
+            AppendArray(report, values);
+            report += i + 1 < phaseCount ? " },\n" : " }\n";
+        }
+
+        std::format_to(out, "  }},\n  \"metrics\": {{\n");
+        auto metrics = SummarizeMetrics();
+        for (std::size_t i = 0; i < metricCount; ++i) {
+            const auto& summary = metrics[i];
+            Collect(static_cast<Metric>(i), values);
+            std::format_to(out, "    \"{}\": {{ \"p50\": {}, \"p99\": {}, \"max\": {}, \"samples\": ",
+                MetricName(static_cast<Metric>(i)), summary.p50, summary.p99, summary.max);
+            AppendArray(report, values);
+            report += i + 1 < metricCount ? " },\n" : " }\n";
+        }
+        report += "  },\n";
+
+        // Expected to be zero, so that a comparison fails on regression.
+        std::format_to(out,
+            "  \"idleFrames\": {{ \"frames\": {}, \"allocatingFrames\": {}, \"allocations\": {}, \"bytes\": {} }},\n",
+            _idleFrames.load(std::memory_order_relaxed), _idleAllocFrames.load(std::memory_order_relaxed),
+            _idleAllocs.load(std::memory_order_relaxed), _idleAllocBytes.load(std::memory_order_relaxed));
+
+        auto latency = SummarizeLatency();
+        CollectLatency(values);
+        std::format_to(out, "  \"inputLatency\": {{ \"p50\": {}, \"p99\": {}, \"max\": {}, \"samples\": ", latency.p50,
+            latency.p99, latency.max);
+        AppendArray(report, values);
+        report += " }\n}\n";
+        return report;
+    }
+
+    void FrameStats::DrawOverlay()
+    {
+        if (!_active) {
+            return;
+        }
+
+        ImGuiWindowFlags window_flags = 0;
+        window_flags |= ImGuiWindowFlags_AlwaysAutoResize;
+        window_flags |= ImGuiWindowFlags_NoFocusOnAppearing;
+        window_flags |= ImGuiWindowFlags_NoNav;
+
+        ImGui::SetNextWindowPos(ImVec2{ 10.0f, 10.0f }, ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.75f);
+        if (ImGui::Begin("Frame Stats", nullptr, window_flags)) {
+            Collect(Phase::kTotal, _values);
+            _graph.clear();
+            for (auto value : _values) {
+                _graph.push_back(Milliseconds(value));
+            }
+            ImGui::PlotLines("##Frames", _graph.data(), static_cast<int>(_graph.size()), 0, "Total (ms)", 0.0f,
+                FLT_MAX, ImVec2{ 0.0f, ImGui::GetTextLineHeight() * 4.0f });
+
+            if (ImGui::BeginTable("Stats", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Phase (ms)");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableSetupColumn("max");
+                ImGui::TableHeadersRow();
+
+                for (std::size_t i = 0; i < phaseCount; ++i) {
+                    Collect(static_cast<Phase>(i), _values);
+                    auto summary = ImGui::Impl::Summarize(_values);
+                    auto name = PhaseName(static_cast<Phase>(i));
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", Milliseconds(summary.p50));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", Milliseconds(summary.p99));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", Milliseconds(summary.max));
+                }
+
+                for (std::size_t i = 0; i < metricCount; ++i) {
+                    Collect(static_cast<Metric>(i), _values);
+                    auto summary = ImGui::Impl::Summarize(_values);
+                    auto name = MetricName(static_cast<Metric>(i));
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", summary.p50);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", summary.p99);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", summary.max);
+                }
+
+                CollectLatency(_values);
+                auto summary = ImGui::Impl::Summarize(_values);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted("Input (ms)");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", Milliseconds(summary.p50));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", Milliseconds(summary.p99));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", Milliseconds(summary.max));
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+
+    void FrameStats::Publish() noexcept
+    {
+        // Single writer, so count is only read back here.
+        auto  count = _count.load(std::memory_order_relaxed);
+        auto& frame = _frames[count % capacity];
+        for (std::size_t i = 0; i < phaseCount; ++i) {
+            frame.phases[i].store(_phases[i], std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < metricCount; ++i) {
+            frame.metrics[i].store(_metrics[i], std::memory_order_relaxed);
+        }
+        _count.store(count + 1, std::memory_order_release);
+    }
+
+    void FrameStats::PublishLatency(std::uint32_t a_us) noexcept
+    {
+        // Single writer, as Publish().
+        auto count = _latencyCount.load(std::memory_order_relaxed);
+        _latencies[count % capacity].store(a_us, std::memory_order_relaxed);
+        _latencyCount.store(count + 1, std::memory_order_release);
+    }
+
+    void FrameStats::Collect(Phase a_phase, std::vector<std::uint32_t>& a_out) const
+    {
+        a_out.clear();
+
+        auto count = _count.load(std::memory_order_acquire);
+        auto size = std::min<std::uint64_t>(count, capacity);
+        a_out.reserve(static_cast<std::size_t>(size));
+        auto phase = static_cast<std::size_t>(a_phase);
+        for (auto i = count - size; i < count; ++i) {
+            a_out.push_back(_frames[i % capacity].phases[phase].load(std::memory_order_relaxed));
+        }
+    }
+
+    void FrameStats::Collect(Metric a_metric, std::vector<std::uint32_t>& a_out) const
+    {
+        a_out.clear();
+
+        auto count = _count.load(std::memory_order_acquire);
+        auto size = std::min<std::uint64_t>(count, capacity);
+        a_out.reserve(static_cast<std::size_t>(size));
+        auto metric = static_cast<std::size_t>(a_metric);
+        for (auto i = count - size; i < count; ++i) {
+            a_out.push_back(_frames[i % capacity].metrics[metric].load(std::memory_order_relaxed));
+        }
+    }
+
+    void FrameStats::CollectLatency(std::vector<std::uint32_t>& a_out) const
+    {
+        a_out.clear();
+
+        auto count = _latencyCount.load(std::memory_order_acquire);
+        auto size = std::min<std::uint64_t>(count, capacity);
+        a_out.reserve(static_cast<std::size_t>(size));
+        for (auto i = count - size; i < count; ++i) {
+            a_out.push_back(_latencies[i % capacity].load(std::memory_order_relaxed));
+        }
+    }
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <XSEPlugin/Util/AllocStats.h>
+
+namespace ImGui::Impl
+{
+    /// Per-phase timings and other metrics of recent frames of renderer, and
+    /// latency from input to the frame that draws its effect.
+    ///
+    /// Render thread records each frame into a fixed-size ring buffer of
+    /// atomics, which other threads read without lock. A slot being written
+    /// while read may mix two frames, which is harmless for statistics.
+    ///
+    /// While disabled, each call costs a single branch.
+    class FrameStats
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Phase : std::uint32_t
+        {
+            kCompletions,
+            kLoad,
+            kFonts,
+            kNewFrame,
+            kDraw,
+            kRender,
+            kRenderDrawData,
+            kTotal,
+        };
+
+        enum class Metric : std::uint32_t
+        {
+            kVertices,
+            kAllocations,  // Heap allocations of render thread.
+            kAllocBytes,
+        };
+
+        static constexpr std::size_t phaseCount = static_cast<std::size_t>(Phase::kTotal) + 1;
+        static constexpr std::size_t metricCount = static_cast<std::size_t>(Metric::kAllocBytes) + 1;
+        static constexpr std::size_t capacity = 256;  // Frames kept, and latencies kept.
+
+        /// Percentiles over frames kept. Phases are in microseconds.
+        struct Summary
+        {
+            std::uint32_t p50;
+            std::uint32_t p99;
+            std::uint32_t max;
+        };
+
+        /// Record from next frame on, or stop recording.
+        void Enable(bool a_enable) noexcept { _enabled.store(a_enable, std::memory_order_relaxed); }
+
+        [[nodiscard]] bool IsEnabled() const noexcept { return _enabled.load(std::memory_order_relaxed); }
+
+        /// Start timing a frame.
+        void Begin() noexcept
+        {
+            _active = IsEnabled();
+            if (_active) {
+                _phases = {};
+                _metrics = {};
+                _allocStart = AllocStats::Current();
+                _start = _last = Clock::now();
+            }
+        }
+
+        /// Charge the time since last mark to the given phase.
+        void Mark(Phase a_phase) noexcept
+        {
+            if (_active) {
+                auto now = Clock::now();
+                _phases[static_cast<std::size_t>(a_phase)] += Microseconds(now - _last);
+                _last = now;
+            }
+        }
+
+        /// Record the number of vertices drawn in current frame.
+        void Count(int a_vertices) noexcept
+        {
+            if (_active) {
+                _metrics[static_cast<std::size_t>(Metric::kVertices)] = static_cast<std::uint32_t>(
+                    std::max(a_vertices, 0));
+            }
+        }
+
+        /// Note the arrival of input that menu will draw. The earliest one is
+        /// kept until a frame consumes it.
+        ///
+        /// @note
+        ///   Thread-safe.
+        void MarkInput(Clock::time_point a_arrival) noexcept
+        {
+            if (IsEnabled()) {
+                std::int64_t expected = 0;
+                _inputArrival.compare_exchange_strong(expected, a_arrival.time_since_epoch().count(),
+                    std::memory_order_relaxed);
+            }
+        }
+
+        /// Record latency of input noted so far, whose effect current frame
+        /// has drawn.
+        void ConsumeInput() noexcept
+        {
+            if (_active) {
+                if (auto arrival = _inputArrival.exchange(0, std::memory_order_relaxed); arrival != 0) {
+                    PublishLatency(Microseconds(Clock::now() - Clock::time_point{ Clock::duration{ arrival } }));
+                }
+            }
+        }
+
+        /// Finish timing a frame and publish it.
+        ///
+        /// @param a_idle
+        ///   Whether the previous frame was drawn again, which is expected to
+        ///   allocate nothing. Every idle frame that allocates is counted.
+        ///
+        /// @return
+        ///   Heap allocations of render thread during frame, or nothing if
+        ///   disabled.
+        AllocStats::Counter End(bool a_idle = false) noexcept
+        {
+            if (!_active) {
+                return { 0, 0 };
+            }
+            auto allocs = AllocStats::Current() - _allocStart;
+            _phases[static_cast<std::size_t>(Phase::kTotal)] = Microseconds(Clock::now() - _start);
+            _metrics[static_cast<std::size_t>(Metric::kAllocations)] = Saturate(allocs.count);
+            _metrics[static_cast<std::size_t>(Metric::kAllocBytes)] = Saturate(allocs.bytes);
+            Publish();
+            if (a_idle) {
+                _idleFrames.fetch_add(1, std::memory_order_relaxed);
+                if (allocs.count > 0) {
+                    _idleAllocFrames.fetch_add(1, std::memory_order_relaxed);
+                    _idleAllocs.fetch_add(allocs.count, std::memory_order_relaxed);
+                    _idleAllocBytes.fetch_add(allocs.bytes, std::memory_order_relaxed);
+                }
+            }
+            return allocs;
+        }
+
+        [[nodiscard]] static std::string_view PhaseName(Phase a_phase) noexcept;
+
+        [[nodiscard]] static std::string_view MetricName(Metric a_metric) noexcept;
+
+        /// Summarize frames kept, by phase.
+        [[nodiscard]] std::array<Summary, phaseCount> Summarize() const;
+
+        /// Summarize frames kept, by metric.
+        [[nodiscard]] std::array<Summary, metricCount> SummarizeMetrics() const;
+
+        /// Summarize input latencies kept.
+        [[nodiscard]] Summary SummarizeLatency() const;
+
+        /// Percentiles of each phase and metric, and histogram of frame time,
+        /// as text.
+        ///
+        /// @note
+        ///   Thread-safe.
+        [[nodiscard]] std::string Report() const;
+
+        /// Percentiles and histogram of input latency, as text.
+        ///
+        /// @note
+        ///   Thread-safe.
+        [[nodiscard]] std::string ReportLatency() const;
+
+        /// Percentiles and samples of each phase and metric, and allocations
+        /// of idle frames since enabled, as JSON.
+        ///
+        /// @note
+        ///   Thread-safe.
+        [[nodiscard]] std::string ReportJSON() const;
+
+        /// Draw frame graph and percentiles of each phase and metric in an
+        /// overlay window, if enabled. Allocate nothing once warmed up.
+        void DrawOverlay();
+
+    private:
+        struct Frame
+        {
+            std::array<std::atomic<std::uint32_t>, phaseCount>  phases;
+            std::array<std::atomic<std::uint32_t>, metricCount> metrics;
+        };
+
+        [[nodiscard]] static std::uint32_t Saturate(std::uint64_t a_value) noexcept
+        {
+            return static_cast<std::uint32_t>(std::min<std::uint64_t>(a_value, UINT32_MAX));
+        }
+
+        [[nodiscard]] static std::uint32_t Microseconds(Clock::duration a_duration) noexcept
+        {
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(a_duration).count();
+            return Saturate(static_cast<std::uint64_t>(std::max<std::int64_t>(us, 0)));
+        }
+
+        void Publish() noexcept;
+
+        void PublishLatency(std::uint32_t a_us) noexcept;
+
+        /// Copy values of a phase of frames kept, from oldest to newest.
+        void Collect(Phase a_phase, std::vector<std::uint32_t>& a_out) const;
+
+        /// Copy values of a metric of frames kept, from oldest to newest.
+        void Collect(Metric a_metric, std::vector<std::uint32_t>& a_out) const;
+
+        /// Copy input latencies kept, from oldest to newest.
+        void CollectLatency(std::vector<std::uint32_t>& a_out) const;
+
+        std::atomic<bool>                      _enabled{ false };
+        bool                                   _active{ false };  // Recording current frame.
+        Clock::time_point                      _start;
+        Clock::time_point                      _last;
+        AllocStats::Counter                    _allocStart{ 0, 0 };
+        std::array<std::uint32_t, phaseCount>  _phases{};
+        std::array<std::uint32_t, metricCount> _metrics{};
+        std::array<Frame, capacity>            _frames{};
+        std::atomic<std::uint64_t>             _count{ 0 };  // Frames published.
+
+        // Idle frames since enabled, and those of them that allocated.
+        std::atomic<std::uint64_t> _idleFrames{ 0 };
+        std::atomic<std::uint64_t> _idleAllocFrames{ 0 };
+        std::atomic<std::uint64_t> _idleAllocs{ 0 };
+        std::atomic<std::uint64_t> _idleAllocBytes{ 0 };
+
+        std::atomic<std::int64_t>                        _inputArrival{ 0 };  // Of input not drawn yet, or 0.
+        std::array<std::atomic<std::uint32_t>, capacity> _latencies{};        // In microseconds.
+        std::atomic<std::uint64_t>                       _latencyCount{ 0 };
+
+        // Reused by overlay on render thread.
+        std::vector<std::uint32_t> _values;
+        std::vector<float>         _graph;
+    };
+}
@@ -0,0 +1,291 @@
+#include "GlyphAtlas.h"
+
+#include <imgui_freetype.h>
+#include <imgui_internal.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_SYNTHESIS_H
+
+#define STBRP_STATIC
+#define STBRP_ASSERT(x) IM_ASSERT(x)
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
+namespace ImGui::Impl
+{
+    namespace
+    {
+        [[nodiscard]] inline int FTCeil(FT_Pos a_value) noexcept { return static_cast<int>((a_value + 63) & -64) / 64; }
+    }
+
+    struct GlyphAtlas::Packer
+    {
+        stbrp_context                  context;
+        std::vector<stbrp_node>        nodes;
+        ImFontAtlasCustomRect          region;  // Reserved space of atlas.
+        std::array<unsigned char, 256> multiply;
+    };
+
+    /// The FreeType face of a font config, set up like the atlas builder does.
+    struct GlyphAtlas::Face
+    {
+        Face() = default;
+
+        Face(const Face&) = delete;
+        Face(Face&&) = delete;
+        Face& operator=(const Face&) = delete;
+        Face& operator=(Face&&) = delete;
+
+        ~Face()
+        {
+            if (face) {
+                FT_Done_Face(face);
+            }
+            if (library) {
+                FT_Done_FreeType(library);
+            }
+        }
+
+        bool Init(const ImFontConfig& a_config, unsigned int a_flags)
+        {
+            if (FT_Init_FreeType(&library) != 0) {
+                return false;
+            }
+            if (FT_New_Memory_Face(library, static_cast<const FT_Byte*>(a_config.FontData),
+                    static_cast<FT_Long>(a_config.FontDataSize), a_config.FontNo, &face) != 0) {
+                return false;
+            }
+            if (FT_Select_Charmap(face, FT_ENCODING_UNICODE) != 0) {
+                return false;
+            }
+
+            flags = a_config.FontBuilderFlags | a_flags;
+
+            loadFlags = 0;
+            if ((flags & ImGuiFreeTypeBuilderFlags_Bitmap) == 0) {
+                loadFlags |= FT_LOAD_NO_BITMAP;
+            }
+            if (flags & ImGuiFreeTypeBuilderFlags_NoHinting) {
+                loadFlags |= FT_LOAD_NO_HINTING;
+            }
+            if (flags & ImGuiFreeTypeBuilderFlags_NoAutoHint) {
+                loadFlags |= FT_LOAD_NO_AUTOHINT;
+            }
+            if (flags & ImGuiFreeTypeBuilderFlags_ForceAutoHint) {
+                loadFlags |= FT_LOAD_FORCE_AUTOHINT;
+            }
+            if (flags & ImGuiFreeTypeBuilderFlags_LightHinting) {
+                loadFlags |= FT_LOAD_TARGET_LIGHT;
+            } else if (flags & ImGuiFreeTypeBuilderFlags_MonoHinting) {
+                loadFlags |= FT_LOAD_TARGET_MONO;
+            } else {
+                loadFlags |= FT_LOAD_TARGET_NORMAL;
+            }
+            if (flags & ImGuiFreeTypeBuilderFlags_LoadColor) {
+                loadFlags |= FT_LOAD_COLOR;
+            }
+            renderMode = (flags & ImGuiFreeTypeBuilderFlags_Monochrome) ? FT_RENDER_MODE_MONO : FT_RENDER_MODE_NORMAL;
+
+            density = a_config.RasterizerDensity;
+
+            FT_Size_RequestRec req{};
+            req.type = (flags & ImGuiFreeTypeBuilderFlags_Bitmap) ? FT_SIZE_REQUEST_TYPE_NOMINAL :
+                                                                    FT_SIZE_REQUEST_TYPE_REAL_DIM;
+            auto pixelHeight = static_cast<std::uint32_t>(a_config.SizePixels);
+            req.height = static_cast<FT_Long>(static_cast<std::uint32_t>(pixelHeight * 64 * density));
+            return FT_Request_Size(face, &req) == 0;
+        }
+
+        FT_Library     library{ nullptr };
+        FT_Face        face{ nullptr };
+        unsigned int   flags{ 0 };
+        FT_Int32       loadFlags{ 0 };
+        FT_Render_Mode renderMode{ FT_RENDER_MODE_NORMAL };
+        float          density{ 1.0f };
+    };
+
+    GlyphAtlas::GlyphAtlas() = default;
+
+    GlyphAtlas::~GlyphAtlas() = default;
+
+    void GlyphAtlas::Reserve(ImFontAtlas* a_atlas, float a_size, int a_count)
+    {
+        // Narrow enough to fit the narrowest atlas the builder picks, which is
+        // 512 pixels including padding.
+        constexpr int width = 480;
+
+        auto cell = static_cast<int>(std::ceil(a_size)) + a_atlas->TexGlyphPadding + 1;
+        auto columns = std::max(width / cell, 1);
+        auto rows = (a_count + columns - 1) / columns;
+        auto height = std::clamp(rows * cell, cell, 2048);
+
+        _reserved = a_atlas->AddCustomRectRegular(width, height);
+    }
+
+    bool GlyphAtlas::Attach(ImFontAtlas* a_atlas)
+    {
+        Detach();
+
+        if (_reserved < 0 || a_atlas->Fonts.empty() || a_atlas->ConfigData.empty()) {
+            return false;
+        }
+
+        auto face = std::make_unique<Face>();
+        if (!face->Init(a_atlas->ConfigData[0], a_atlas->FontBuilderFlags)) {
+            return false;
+        }
+
+        const auto& region = *a_atlas->GetCustomRectByIndex(_reserved);
+        if (!region.IsPacked()) {
+            return false;
+        }
+
+        auto padding = a_atlas->TexGlyphPadding;
+        auto packer = std::make_unique<Packer>();
+        packer->region = region;
+        packer->nodes.resize(region.Width);
+        stbrp_init_target(std::addressof(packer->context), region.Width - padding, region.Height - padding,
+            packer->nodes.data(), static_cast<int>(packer->nodes.size()));
+        ImFontAtlasBuildMultiplyCalcLookupTable(packer->multiply.data(), a_atlas->ConfigData[0].RasterizerMultiply);
+
+        _atlas = a_atlas;
+        _font = a_atlas->Fonts[0];
+        _packer = std::move(packer);
+        _face = std::move(face);
+        _dirty = { 0, 0, 0, 0 };
+        return true;
+    }
+
+    void GlyphAtlas::Detach() noexcept
+    {
+        _atlas = nullptr;
+        _font = nullptr;
+        _packer.reset();
+        _face.reset();
+    }
+
+    bool GlyphAtlas::AddGlyph(ImWchar a_codepoint)
+    {
+        if (!IsAttached()) {
+            return false;
+        }
+
+        auto face = _face->face;
+        auto index = FT_Get_Char_Index(face, a_codepoint);
+        if (index == 0) {
+            // The builder skips it too, so fallback glyph is drawn.
+            return true;
+        }
+        if (FT_Load_Glyph(face, index, _face->loadFlags) != 0) {
+            return true;
+        }
+
+        auto slot = face->glyph;
+        if (_face->flags & ImGuiFreeTypeBuilderFlags_Bold) {
+            FT_GlyphSlot_Embolden(slot);
+        }
+        if (_face->flags & ImGuiFreeTypeBuilderFlags_Oblique) {
+            FT_GlyphSlot_Oblique(slot);
+        }
+        if (FT_Render_Glyph(slot, _face->renderMode) != 0) {
+            return true;
+        }
+
+        const auto& bitmap = slot->bitmap;
+        if (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY && bitmap.pixel_mode != FT_PIXEL_MODE_MONO) {
+            // Colored glyphs are left to the builder.
+            return false;
+        }
+
+        auto width = static_cast<int>(bitmap.width);
+        auto height = static_cast<int>(bitmap.rows);
+        auto padding = _atlas->TexGlyphPadding;
+
+        stbrp_rect rect{};
+        rect.w = static_cast<stbrp_coord>(width + padding);
+        rect.h = static_cast<stbrp_coord>(height + padding);
+        stbrp_pack_rects(std::addressof(_packer->context), std::addressof(rect), 1);
+        if (!rect.was_packed) {
+            return false;
+        }
+
+        auto tx = _packer->region.X + rect.x + padding;
+        auto ty = _packer->region.Y + rect.y + padding;
+        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
+            // Expand to one byte per pixel.
+            std::vector<unsigned char> gray(static_cast<std::size_t>(width) * height);
+            for (int y = 0; y < height; ++y) {
+                const auto* row = bitmap.buffer + y * bitmap.pitch;
+                for (int x = 0; x < width; ++x) {
+                    gray[static_cast<std::size_t>(y) * width + x] = (row[x >> 3] & (0x80 >> (x & 7))) ? 255 : 0;
+                }
+            }
+            Blit(gray.data(), width, width, height, tx, ty);
+        } else {
+            Blit(bitmap.buffer, bitmap.pitch, width, height, tx, ty);
+        }
+
+        // Drop tab glyph, which lookup tables append again after the last glyph.
+        if (!_font->Glyphs.empty() && _font->Glyphs.back().Codepoint == '\t') {
+            _font->Glyphs.pop_back();
+        }
+
+        const auto& config = _atlas->ConfigData[0];
+        auto        inv = 1.0f / _face->density;
+        auto        offsetX = config.GlyphOffset.x;
+        auto        offsetY = config.GlyphOffset.y + IM_ROUND(_font->Ascent);
+
+        auto x0 = static_cast<float>(slot->bitmap_left) * inv + offsetX;
+        auto y0 = static_cast<float>(-slot->bitmap_top) * inv + offsetY;
+        auto x1 = x0 + static_cast<float>(width) * inv;
+        auto y1 = y0 + static_cast<float>(height) * inv;
+        auto u0 = static_cast<float>(tx) / static_cast<float>(_atlas->TexWidth);
+        auto v0 = static_cast<float>(ty) / static_cast<float>(_atlas->TexHeight);
+        auto u1 = static_cast<float>(tx + width) / static_cast<float>(_atlas->TexWidth);
+        auto v1 = static_cast<float>(ty + height) / static_cast<float>(_atlas->TexHeight);
+        auto advance = static_cast<float>(FTCeil(slot->advance.x)) * inv;
+        _font->AddGlyph(std::addressof(config), a_codepoint, x0, y0, x1, y1, u0, v0, u1, v1, advance);
+        return true;
+    }
+
+    void GlyphAtlas::Commit()
+    {
+        if (IsAttached() && _font->DirtyLookupTables) {
+            _font->BuildLookupTable();
+        }
+    }
+
+    GlyphAtlas::Rect GlyphAtlas::TakeDirty() noexcept { return std::exchange(_dirty, Rect{ 0, 0, 0, 0 }); }
+
+    void GlyphAtlas::Blit(const unsigned char* a_src, int a_pitch, int a_width, int a_height, int a_x, int a_y)
+    {
+        const auto& multiply = _packer->multiply;
+        auto        stride = static_cast<std::size_t>(_atlas->TexWidth);
+
+        for (int y = 0; y < a_height; ++y) {
+            const auto* src = a_src + static_cast<std::ptrdiff_t>(y) * a_pitch;
+            auto        offset = (static_cast<std::size_t>(a_y) + y) * stride + a_x;
+            if (auto alpha = _atlas->TexPixelsAlpha8) {
+                for (int x = 0; x < a_width; ++x) {
+                    alpha[offset + x] = multiply[src[x]];
+                }
+            }
+            if (auto rgba = _atlas->TexPixelsRGBA32) {
+                for (int x = 0; x < a_width; ++x) {
+                    rgba[offset + x] = IM_COL32(255, 255, 255, multiply[src[x]]);
+                }
+            }
+        }
+
+        if (a_width == 0 || a_height == 0) {
+            return;
+        }
+        if (_dirty.x1 == _dirty.x0) {
+            _dirty = { a_x, a_y, a_x + a_width, a_y + a_height };
+        } else {
+            _dirty = { std::min(_dirty.x0, a_x), std::min(_dirty.y0, a_y), std::max(_dirty.x1, a_x + a_width),
+                std::max(_dirty.y1, a_y + a_height) };
+        }
+    }
+}
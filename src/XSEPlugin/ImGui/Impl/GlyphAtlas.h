@@ -0,0 +1,77 @@
+#pragma once
+
+#include <imgui.h>
+
+namespace ImGui::Impl
+{
+    /// Free space reserved in a built font atlas, into which new glyphs are
+    /// rasterized and packed one at a time, so that a new character does not
+    /// require rebuilding the whole atlas.
+    ///
+    /// Glyphs are rasterized with FreeType the same way as the atlas builder,
+    /// and written to both alpha and RGBA pixels of atlas.
+    class GlyphAtlas
+    {
+    public:
+        /// A region of atlas texture, in pixels.
+        struct Rect
+        {
+            int x0;
+            int y0;
+            int x1;
+            int y1;
+        };
+
+        GlyphAtlas();
+
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas(GlyphAtlas&&) = delete;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(GlyphAtlas&&) = delete;
+
+        ~GlyphAtlas();
+
+        /// Reserve free space for about the given number of glyphs of the
+        /// given size. Must be called after fonts are added and before atlas
+        /// is built.
+        void Reserve(ImFontAtlas* a_atlas, float a_size, int a_count);
+
+        /// Start packing into reserved space of the built atlas, for its first
+        /// font.
+        ///
+        /// @return
+        ///   False if there is no reserved space or font cannot be loaded.
+        bool Attach(ImFontAtlas* a_atlas);
+
+        /// Stop packing, before atlas is cleared.
+        void Detach() noexcept;
+
+        [[nodiscard]] bool IsAttached() const noexcept { return _atlas != nullptr; }
+
+        /// Rasterize glyph into free space and add it to font. Characters
+        /// missing from font are skipped.
+        ///
+        /// @return
+        ///   False if there is no room left, so atlas must be rebuilt.
+        bool AddGlyph(ImWchar a_codepoint);
+
+        /// Update lookup tables of font after glyphs are added.
+        void Commit();
+
+        /// Take the region written since last call, or an empty one.
+        [[nodiscard]] Rect TakeDirty() noexcept;
+
+    private:
+        struct Packer;
+        struct Face;
+
+        void Blit(const unsigned char* a_src, int a_pitch, int a_width, int a_height, int a_x, int a_y);
+
+        ImFontAtlas*            _atlas{ nullptr };
+        ImFont*                 _font{ nullptr };
+        int                     _reserved{ -1 };  // Index of custom rect.
+        std::unique_ptr<Packer> _packer;
+        std::unique_ptr<Face>   _face;
+        Rect                    _dirty{ 0, 0, 0, 0 };
+    };
+}
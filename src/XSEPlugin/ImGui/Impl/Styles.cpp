@@ -16,9 +16,9 @@ namespace ImGui::Impl
         }
     }
 
-    void Styles::Load()
+    void Styles::Load(const Configuration& a_config)
     {
-        auto& cfgStyles = Configuration::GetSingleton()->styles;
+        const auto& cfgStyles = a_config.styles;
 
         auto& style = ImGui::GetStyle();
         auto  colors = style.Colors;
@@ -1,15 +1,13 @@
 #pragma once
 
+#include <XSEPlugin/Base/Configuration.h>
+
 namespace ImGui::Impl
 {
     class Styles
     {
     public:
-        /// Fetch and apply the latest styles.
-        ///
-        /// @note
-        ///   Assume caller has already acquired shared lock of
-        ///   configuration before calling.
-        void Load();
+        /// Apply styles of the given snapshot.
+        void Load(const Configuration& a_config);
     };
 }
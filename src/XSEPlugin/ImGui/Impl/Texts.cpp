@@ -4,12 +4,13 @@
 
 namespace ImGui::Impl
 {
-    void Texts::Load()
+    void Texts::Load(const Translation& a_trans)
     {
-        auto trans = Translation::GetSingleton();
-
-        Title = trans->Lookup("$Title"sv);
-        Section_Mod = trans->Lookup("$Section_Mod"sv);
-        Section_Config = trans->Lookup("$Section_Config"sv);
+        Title = a_trans.Lookup("$Title"sv);
+        Section_Mod = a_trans.Lookup("$Section_Mod"sv);
+        Section_Config = a_trans.Lookup("$Section_Config"sv);
+        Running = a_trans.Lookup("$Running"sv);
+        Loading = a_trans.Lookup("$Loading"sv);
+        Search = a_trans.Lookup("$Search"sv);
     }
 }
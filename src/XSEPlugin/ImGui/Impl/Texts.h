@@ -1,19 +1,20 @@
 #pragma once
 
+#include <XSEPlugin/Base/Translation.h>
+
 namespace ImGui::Impl
 {
     class Texts
     {
     public:
-        /// Fetch and apply the latest texts.
-        ///
-        /// @note
-        ///   Assume caller has already acquired shared lock of
-        ///   translation before calling.
-        void Load();
+        /// Apply texts of the given snapshot.
+        void Load(const Translation& a_trans);
 
         std::string Title;
         std::string Section_Mod;
         std::string Section_Config;
+        std::string Running;
+        std::string Loading;
+        std::string Search;
     };
 }
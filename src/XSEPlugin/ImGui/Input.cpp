@@ -2,332 +2,178 @@
 
 #include <imgui.h>
 
+#include <XSEPlugin/Util/CLib/Key.h>
+
 namespace ImGui
 {
     namespace
     {
-        inline ImGuiKey ParseKeyFromKeyboard(RE::BSKeyboardDevice::Key a_key)
-        {
-            switch (a_key) {
-            // 512
-            case RE::BSKeyboardDevice::Key::kTab:
-                return ImGuiKey_Tab;
-            case RE::BSKeyboardDevice::Key::kLeft:
-                return ImGuiKey_LeftArrow;
-            case RE::BSKeyboardDevice::Key::kRight:
-                return ImGuiKey_RightArrow;
-            case RE::BSKeyboardDevice::Key::kUp:
-                return ImGuiKey_UpArrow;
-            case RE::BSKeyboardDevice::Key::kDown:
-                return ImGuiKey_DownArrow;
-            case RE::BSKeyboardDevice::Key::kPageUp:
-                return ImGuiKey_PageUp;
-            case RE::BSKeyboardDevice::Key::kPageDown:
-                return ImGuiKey_PageDown;
-            case RE::BSKeyboardDevice::Key::kHome:
-                return ImGuiKey_Home;
-            case RE::BSKeyboardDevice::Key::kEnd:
-                return ImGuiKey_End;
-            case RE::BSKeyboardDevice::Key::kInsert:
-                return ImGuiKey_Insert;
-            case RE::BSKeyboardDevice::Key::kDelete:
-                return ImGuiKey_Delete;
-            case RE::BSKeyboardDevice::Key::kBackspace:
-                return ImGuiKey_Backspace;
-            case RE::BSKeyboardDevice::Key::kSpacebar:
-                return ImGuiKey_Space;
-            case RE::BSKeyboardDevice::Key::kEnter:
-                return ImGuiKey_Enter;
-            case RE::BSKeyboardDevice::Key::kEscape:
-                return ImGuiKey_Escape;
-            case RE::BSKeyboardDevice::Key::kLeftControl:
-                return ImGuiKey_LeftCtrl;
-            case RE::BSKeyboardDevice::Key::kLeftShift:
-                return ImGuiKey_LeftShift;
-            case RE::BSKeyboardDevice::Key::kLeftAlt:
-                return ImGuiKey_LeftAlt;
-            case RE::BSKeyboardDevice::Key::kLeftWin:
-                return ImGuiKey_LeftSuper;
-            case RE::BSKeyboardDevice::Key::kRightControl:
-                return ImGuiKey_RightCtrl;
-            case RE::BSKeyboardDevice::Key::kRightShift:
-                return ImGuiKey_RightShift;
-            case RE::BSKeyboardDevice::Key::kRightAlt:
-                return ImGuiKey_RightAlt;
-            case RE::BSKeyboardDevice::Key::kRightWin:
-                return ImGuiKey_RightSuper;
-            // Skip 535
-            case RE::BSKeyboardDevice::Key::kNum0:
-                return ImGuiKey_0;
-            case RE::BSKeyboardDevice::Key::kNum1:
-                return ImGuiKey_1;
-            case RE::BSKeyboardDevice::Key::kNum2:
-                return ImGuiKey_2;
-            case RE::BSKeyboardDevice::Key::kNum3:
-                return ImGuiKey_3;
-            case RE::BSKeyboardDevice::Key::kNum4:
-                return ImGuiKey_4;
-            case RE::BSKeyboardDevice::Key::kNum5:
-                return ImGuiKey_5;
-            case RE::BSKeyboardDevice::Key::kNum6:
-                return ImGuiKey_6;
-            case RE::BSKeyboardDevice::Key::kNum7:
-                return ImGuiKey_7;
-            case RE::BSKeyboardDevice::Key::kNum8:
-                return ImGuiKey_8;
-            case RE::BSKeyboardDevice::Key::kNum9:
-                return ImGuiKey_9;
-            case RE::BSKeyboardDevice::Key::kA:
-                return ImGuiKey_A;
-            case RE::BSKeyboardDevice::Key::kB:
-                return ImGuiKey_B;
-            case RE::BSKeyboardDevice::Key::kC:
-                return ImGuiKey_C;
-            case RE::BSKeyboardDevice::Key::kD:
-                return ImGuiKey_D;
-            case RE::BSKeyboardDevice::Key::kE:
-                return ImGuiKey_E;
-            case RE::BSKeyboardDevice::Key::kF:
-                return ImGuiKey_F;
-            case RE::BSKeyboardDevice::Key::kG:
-                return ImGuiKey_G;
-            case RE::BSKeyboardDevice::Key::kH:
-                return ImGuiKey_H;
-            case RE::BSKeyboardDevice::Key::kI:
-                return ImGuiKey_I;
-            case RE::BSKeyboardDevice::Key::kJ:
-                return ImGuiKey_J;
-            case RE::BSKeyboardDevice::Key::kK:
-                return ImGuiKey_K;
-            case RE::BSKeyboardDevice::Key::kL:
-                return ImGuiKey_L;
-            case RE::BSKeyboardDevice::Key::kM:
-                return ImGuiKey_M;
-            case RE::BSKeyboardDevice::Key::kN:
-                return ImGuiKey_N;
-            case RE::BSKeyboardDevice::Key::kO:
-                return ImGuiKey_O;
-            case RE::BSKeyboardDevice::Key::kP:
-                return ImGuiKey_P;
-            case RE::BSKeyboardDevice::Key::kQ:
-                return ImGuiKey_Q;
-            case RE::BSKeyboardDevice::Key::kR:
-                return ImGuiKey_R;
-            case RE::BSKeyboardDevice::Key::kS:
-                return ImGuiKey_S;
-            case RE::BSKeyboardDevice::Key::kT:
-                return ImGuiKey_T;
-            case RE::BSKeyboardDevice::Key::kU:
-                return ImGuiKey_U;
-            case RE::BSKeyboardDevice::Key::kV:
-                return ImGuiKey_V;
-            case RE::BSKeyboardDevice::Key::kW:
-                return ImGuiKey_W;
-            case RE::BSKeyboardDevice::Key::kX:
-                return ImGuiKey_X;
-            case RE::BSKeyboardDevice::Key::kY:
-                return ImGuiKey_Y;
-            case RE::BSKeyboardDevice::Key::kZ:
-                return ImGuiKey_Z;
-            case RE::BSKeyboardDevice::Key::kF1:
-                return ImGuiKey_F1;
-            case RE::BSKeyboardDevice::Key::kF2:
-                return ImGuiKey_F2;
-            case RE::BSKeyboardDevice::Key::kF3:
-                return ImGuiKey_F3;
-            case RE::BSKeyboardDevice::Key::kF4:
-                return ImGuiKey_F4;
-            case RE::BSKeyboardDevice::Key::kF5:
-                return ImGuiKey_F5;
-            case RE::BSKeyboardDevice::Key::kF6:
-                return ImGuiKey_F6;
-            case RE::BSKeyboardDevice::Key::kF7:
-                return ImGuiKey_F7;
-            case RE::BSKeyboardDevice::Key::kF8:
-                return ImGuiKey_F8;
-            case RE::BSKeyboardDevice::Key::kF9:
-                return ImGuiKey_F9;
-            case RE::BSKeyboardDevice::Key::kF10:
-                return ImGuiKey_F10;
-            case RE::BSKeyboardDevice::Key::kF11:
-                return ImGuiKey_F11;
-            case RE::BSKeyboardDevice::Key::kF12:
-                return ImGuiKey_F12;
-            // Skip 584 ~ 595
-            case RE::BSKeyboardDevice::Key::kApostrophe:
-                return ImGuiKey_Apostrophe;
-            case RE::BSKeyboardDevice::Key::kComma:
-                return ImGuiKey_Comma;
-            case RE::BSKeyboardDevice::Key::kMinus:
-                return ImGuiKey_Minus;
-            case RE::BSKeyboardDevice::Key::kPeriod:
-                return ImGuiKey_Period;
-            case RE::BSKeyboardDevice::Key::kSlash:
-                return ImGuiKey_Slash;
-            case RE::BSKeyboardDevice::Key::kSemicolon:
-                return ImGuiKey_Semicolon;
-            case RE::BSKeyboardDevice::Key::kEquals:
-                return ImGuiKey_Equal;
-            case RE::BSKeyboardDevice::Key::kBracketLeft:
-                return ImGuiKey_LeftBracket;
-            case RE::BSKeyboardDevice::Key::kBackslash:
-                return ImGuiKey_Backslash;
-            case RE::BSKeyboardDevice::Key::kBracketRight:
-                return ImGuiKey_RightBracket;
-            case RE::BSKeyboardDevice::Key::kTilde:
-                return ImGuiKey_GraveAccent;
-            case RE::BSKeyboardDevice::Key::kCapsLock:
-                return ImGuiKey_CapsLock;
-            case RE::BSKeyboardDevice::Key::kScrollLock:
-                return ImGuiKey_ScrollLock;
-            case RE::BSKeyboardDevice::Key::kNumLock:
-                return ImGuiKey_NumLock;
-            case RE::BSKeyboardDevice::Key::kPrintScreen:
-                return ImGuiKey_PrintScreen;
-            case RE::BSKeyboardDevice::Key::kPause:
-                return ImGuiKey_Pause;
-            case RE::BSKeyboardDevice::Key::kKP_0:
-                return ImGuiKey_Keypad0;
-            case RE::BSKeyboardDevice::Key::kKP_1:
-                return ImGuiKey_Keypad1;
-            case RE::BSKeyboardDevice::Key::kKP_2:
-                return ImGuiKey_Keypad2;
-            case RE::BSKeyboardDevice::Key::kKP_3:
-                return ImGuiKey_Keypad3;
-            case RE::BSKeyboardDevice::Key::kKP_4:
-                return ImGuiKey_Keypad4;
-            case RE::BSKeyboardDevice::Key::kKP_5:
-                return ImGuiKey_Keypad5;
-            case RE::BSKeyboardDevice::Key::kKP_6:
-                return ImGuiKey_Keypad6;
-            case RE::BSKeyboardDevice::Key::kKP_7:
-                return ImGuiKey_Keypad7;
-            case RE::BSKeyboardDevice::Key::kKP_8:
-                return ImGuiKey_Keypad8;
-            case RE::BSKeyboardDevice::Key::kKP_9:
-                return ImGuiKey_Keypad9;
-            case RE::BSKeyboardDevice::Key::kKP_Decimal:
-                return ImGuiKey_KeypadDecimal;
-            case RE::BSKeyboardDevice::Key::kKP_Divide:
-                return ImGuiKey_KeypadDivide;
-            case RE::BSKeyboardDevice::Key::kKP_Multiply:
-                return ImGuiKey_KeypadMultiply;
-            case RE::BSKeyboardDevice::Key::kKP_Subtract:
-                return ImGuiKey_KeypadSubtract;
-            case RE::BSKeyboardDevice::Key::kKP_Plus:
-                return ImGuiKey_KeypadAdd;
-            case RE::BSKeyboardDevice::Key::kKP_Enter:
-                return ImGuiKey_KeypadEnter;
-            // Skip 628 ~ 630
-            default:
-                return ImGuiKey_None;
-            }
-        }
-
-        inline ImGuiKey ParseKeyFromKeyboard(std::uint32_t a_key)
-        {
-            return ParseKeyFromKeyboard(static_cast<RE::BSKeyboardDevice::Key>(a_key));
-        }
+        std::atomic<std::uint32_t> inputVersion{ 0 };
 
-        inline ImGuiKey ParseKeyFromGamepad(RE::BSWin32GamepadDevice::Key a_key)
-        {
-            switch (a_key) {
-            case RE::BSWin32GamepadDevice::Key::kUp:
-                return ImGuiKey_GamepadDpadUp;
-            case RE::BSWin32GamepadDevice::Key::kDown:
-                return ImGuiKey_GamepadDpadDown;
-            case RE::BSWin32GamepadDevice::Key::kLeft:
-                return ImGuiKey_GamepadDpadLeft;
-            case RE::BSWin32GamepadDevice::Key::kRight:
-                return ImGuiKey_GamepadDpadRight;
-            case RE::BSWin32GamepadDevice::Key::kStart:
-                return ImGuiKey_GamepadStart;
-            case RE::BSWin32GamepadDevice::Key::kBack:
-                return ImGuiKey_GamepadBack;
-            case RE::BSWin32GamepadDevice::Key::kLeftThumb:
-                return ImGuiKey_GamepadL3;
-            case RE::BSWin32GamepadDevice::Key::kRightThumb:
-                return ImGuiKey_GamepadR3;
-            case RE::BSWin32GamepadDevice::Key::kLeftShoulder:
-                return ImGuiKey_GamepadL1;
-            case RE::BSWin32GamepadDevice::Key::kRightShoulder:
-                return ImGuiKey_GamepadR1;
-            case RE::BSWin32GamepadDevice::Key::kA:
-                return ImGuiKey_GamepadFaceDown;
-            case RE::BSWin32GamepadDevice::Key::kB:
-                return ImGuiKey_GamepadFaceRight;
-            case RE::BSWin32GamepadDevice::Key::kX:
-                return ImGuiKey_GamepadFaceLeft;
-            case RE::BSWin32GamepadDevice::Key::kY:
-                return ImGuiKey_GamepadFaceUp;
-            default:
-                return ImGuiKey_None;
-            }
-        }
+        /// ImGui keys of keyboard and gamepad buttons, by keycode of CLib::ParseKey.
+        constexpr inline auto kKeys = [] {
+            std::array<ImGuiKey, SKSE::InputMap::kMaxMacros> table{};
+            auto keyboard = [&table](RE::BSKeyboardDevice::Key a_key, ImGuiKey a_imKey) {
+                table[CLib::ParseKey(static_cast<std::uint32_t>(a_key), RE::INPUT_DEVICE::kKeyboard)] = a_imKey;
+            };
+            auto gamepad = [&table](RE::BSWin32GamepadDevice::Key a_key, ImGuiKey a_imKey) {
+                table[CLib::ParseKey(static_cast<std::uint32_t>(a_key), RE::INPUT_DEVICE::kGamepad)] = a_imKey;
+            };
+            keyboard(RE::BSKeyboardDevice::Key::kTab, ImGuiKey_Tab);
+            keyboard(RE::BSKeyboardDevice::Key::kLeft, ImGuiKey_LeftArrow);
+            keyboard(RE::BSKeyboardDevice::Key::kRight, ImGuiKey_RightArrow);
+            keyboard(RE::BSKeyboardDevice::Key::kUp, ImGuiKey_UpArrow);
+            keyboard(RE::BSKeyboardDevice::Key::kDown, ImGuiKey_DownArrow);
+            keyboard(RE::BSKeyboardDevice::Key::kPageUp, ImGuiKey_PageUp);
+            keyboard(RE::BSKeyboardDevice::Key::kPageDown, ImGuiKey_PageDown);
+            keyboard(RE::BSKeyboardDevice::Key::kHome, ImGuiKey_Home);
+            keyboard(RE::BSKeyboardDevice::Key::kEnd, ImGuiKey_End);
+            keyboard(RE::BSKeyboardDevice::Key::kInsert, ImGuiKey_Insert);
+            keyboard(RE::BSKeyboardDevice::Key::kDelete, ImGuiKey_Delete);
+            keyboard(RE::BSKeyboardDevice::Key::kBackspace, ImGuiKey_Backspace);
+            keyboard(RE::BSKeyboardDevice::Key::kSpacebar, ImGuiKey_Space);
+            keyboard(RE::BSKeyboardDevice::Key::kEnter, ImGuiKey_Enter);
+            keyboard(RE::BSKeyboardDevice::Key::kEscape, ImGuiKey_Escape);
+            keyboard(RE::BSKeyboardDevice::Key::kLeftControl, ImGuiKey_LeftCtrl);
+            keyboard(RE::BSKeyboardDevice::Key::kLeftShift, ImGuiKey_LeftShift);
+            keyboard(RE::BSKeyboardDevice::Key::kLeftAlt, ImGuiKey_LeftAlt);
+            keyboard(RE::BSKeyboardDevice::Key::kLeftWin, ImGuiKey_LeftSuper);
+            keyboard(RE::BSKeyboardDevice::Key::kRightControl, ImGuiKey_RightCtrl);
+            keyboard(RE::BSKeyboardDevice::Key::kRightShift, ImGuiKey_RightShift);
+            keyboard(RE::BSKeyboardDevice::Key::kRightAlt, ImGuiKey_RightAlt);
+            keyboard(RE::BSKeyboardDevice::Key::kRightWin, ImGuiKey_RightSuper);
+            keyboard(RE::BSKeyboardDevice::Key::kNum0, ImGuiKey_0);
+            keyboard(RE::BSKeyboardDevice::Key::kNum1, ImGuiKey_1);
+            keyboard(RE::BSKeyboardDevice::Key::kNum2, ImGuiKey_2);
+            keyboard(RE::BSKeyboardDevice::Key::kNum3, ImGuiKey_3);
+            keyboard(RE::BSKeyboardDevice::Key::kNum4, ImGuiKey_4);
+            keyboard(RE::BSKeyboardDevice::Key::kNum5, ImGuiKey_5);
+            keyboard(RE::BSKeyboardDevice::Key::kNum6, ImGuiKey_6);
+            keyboard(RE::BSKeyboardDevice::Key::kNum7, ImGuiKey_7);
+            keyboard(RE::BSKeyboardDevice::Key::kNum8, ImGuiKey_8);
+            keyboard(RE::BSKeyboardDevice::Key::kNum9, ImGuiKey_9);
+            keyboard(RE::BSKeyboardDevice::Key::kA, ImGuiKey_A);
+            keyboard(RE::BSKeyboardDevice::Key::kB, ImGuiKey_B);
+            keyboard(RE::BSKeyboardDevice::Key::kC, ImGuiKey_C);
+            keyboard(RE::BSKeyboardDevice::Key::kD, ImGuiKey_D);
+            keyboard(RE::BSKeyboardDevice::Key::kE, ImGuiKey_E);
+            keyboard(RE::BSKeyboardDevice::Key::kF, ImGuiKey_F);
+            keyboard(RE::BSKeyboardDevice::Key::kG, ImGuiKey_G);
+            keyboard(RE::BSKeyboardDevice::Key::kH, ImGuiKey_H);
+            keyboard(RE::BSKeyboardDevice::Key::kI, ImGuiKey_I);
+            keyboard(RE::BSKeyboardDevice::Key::kJ, ImGuiKey_J);
+            keyboard(RE::BSKeyboardDevice::Key::kK, ImGuiKey_K);
+            keyboard(RE::BSKeyboardDevice::Key::kL, ImGuiKey_L);
+            keyboard(RE::BSKeyboardDevice::Key::kM, ImGuiKey_M);
+            keyboard(RE::BSKeyboardDevice::Key::kN, ImGuiKey_N);
+            keyboard(RE::BSKeyboardDevice::Key::kO, ImGuiKey_O);
+            keyboard(RE::BSKeyboardDevice::Key::kP, ImGuiKey_P);
+            keyboard(RE::BSKeyboardDevice::Key::kQ, ImGuiKey_Q);
+            keyboard(RE::BSKeyboardDevice::Key::kR, ImGuiKey_R);
+            keyboard(RE::BSKeyboardDevice::Key::kS, ImGuiKey_S);
+            keyboard(RE::BSKeyboardDevice::Key::kT, ImGuiKey_T);
+            keyboard(RE::BSKeyboardDevice::Key::kU, ImGuiKey_U);
+            keyboard(RE::BSKeyboardDevice::Key::kV, ImGuiKey_V);
+            keyboard(RE::BSKeyboardDevice::Key::kW, ImGuiKey_W);
+            keyboard(RE::BSKeyboardDevice::Key::kX, ImGuiKey_X);
+            keyboard(RE::BSKeyboardDevice::Key::kY, ImGuiKey_Y);
+            keyboard(RE::BSKeyboardDevice::Key::kZ, ImGuiKey_Z);
+            keyboard(RE::BSKeyboardDevice::Key::kF1, ImGuiKey_F1);
+            keyboard(RE::BSKeyboardDevice::Key::kF2, ImGuiKey_F2);
+            keyboard(RE::BSKeyboardDevice::Key::kF3, ImGuiKey_F3);
+            keyboard(RE::BSKeyboardDevice::Key::kF4, ImGuiKey_F4);
+            keyboard(RE::BSKeyboardDevice::Key::kF5, ImGuiKey_F5);
+            keyboard(RE::BSKeyboardDevice::Key::kF6, ImGuiKey_F6);
+            keyboard(RE::BSKeyboardDevice::Key::kF7, ImGuiKey_F7);
+            keyboard(RE::BSKeyboardDevice::Key::kF8, ImGuiKey_F8);
+            keyboard(RE::BSKeyboardDevice::Key::kF9, ImGuiKey_F9);
+            keyboard(RE::BSKeyboardDevice::Key::kF10, ImGuiKey_F10);
+            keyboard(RE::BSKeyboardDevice::Key::kF11, ImGuiKey_F11);
+            keyboard(RE::BSKeyboardDevice::Key::kF12, ImGuiKey_F12);
+            keyboard(RE::BSKeyboardDevice::Key::kApostrophe, ImGuiKey_Apostrophe);
+            keyboard(RE::BSKeyboardDevice::Key::kComma, ImGuiKey_Comma);
+            keyboard(RE::BSKeyboardDevice::Key::kMinus, ImGuiKey_Minus);
+            keyboard(RE::BSKeyboardDevice::Key::kPeriod, ImGuiKey_Period);
+            keyboard(RE::BSKeyboardDevice::Key::kSlash, ImGuiKey_Slash);
+            keyboard(RE::BSKeyboardDevice::Key::kSemicolon, ImGuiKey_Semicolon);
+            keyboard(RE::BSKeyboardDevice::Key::kEquals, ImGuiKey_Equal);
+            keyboard(RE::BSKeyboardDevice::Key::kBracketLeft, ImGuiKey_LeftBracket);
+            keyboard(RE::BSKeyboardDevice::Key::kBackslash, ImGuiKey_Backslash);
+            keyboard(RE::BSKeyboardDevice::Key::kBracketRight, ImGuiKey_RightBracket);
+            keyboard(RE::BSKeyboardDevice::Key::kTilde, ImGuiKey_GraveAccent);
+            keyboard(RE::BSKeyboardDevice::Key::kCapsLock, ImGuiKey_CapsLock);
+            keyboard(RE::BSKeyboardDevice::Key::kScrollLock, ImGuiKey_ScrollLock);
+            keyboard(RE::BSKeyboardDevice::Key::kNumLock, ImGuiKey_NumLock);
+            keyboard(RE::BSKeyboardDevice::Key::kPrintScreen, ImGuiKey_PrintScreen);
+            keyboard(RE::BSKeyboardDevice::Key::kPause, ImGuiKey_Pause);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_0, ImGuiKey_Keypad0);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_1, ImGuiKey_Keypad1);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_2, ImGuiKey_Keypad2);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_3, ImGuiKey_Keypad3);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_4, ImGuiKey_Keypad4);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_5, ImGuiKey_Keypad5);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_6, ImGuiKey_Keypad6);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_7, ImGuiKey_Keypad7);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_8, ImGuiKey_Keypad8);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_9, ImGuiKey_Keypad9);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_Decimal, ImGuiKey_KeypadDecimal);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_Divide, ImGuiKey_KeypadDivide);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_Multiply, ImGuiKey_KeypadMultiply);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_Subtract, ImGuiKey_KeypadSubtract);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_Plus, ImGuiKey_KeypadAdd);
+            keyboard(RE::BSKeyboardDevice::Key::kKP_Enter, ImGuiKey_KeypadEnter);
+            gamepad(RE::BSWin32GamepadDevice::Key::kUp, ImGuiKey_GamepadDpadUp);
+            gamepad(RE::BSWin32GamepadDevice::Key::kDown, ImGuiKey_GamepadDpadDown);
+            gamepad(RE::BSWin32GamepadDevice::Key::kLeft, ImGuiKey_GamepadDpadLeft);
+            gamepad(RE::BSWin32GamepadDevice::Key::kRight, ImGuiKey_GamepadDpadRight);
+            gamepad(RE::BSWin32GamepadDevice::Key::kStart, ImGuiKey_GamepadStart);
+            gamepad(RE::BSWin32GamepadDevice::Key::kBack, ImGuiKey_GamepadBack);
+            gamepad(RE::BSWin32GamepadDevice::Key::kLeftThumb, ImGuiKey_GamepadL3);
+            gamepad(RE::BSWin32GamepadDevice::Key::kRightThumb, ImGuiKey_GamepadR3);
+            gamepad(RE::BSWin32GamepadDevice::Key::kLeftShoulder, ImGuiKey_GamepadL1);
+            gamepad(RE::BSWin32GamepadDevice::Key::kRightShoulder, ImGuiKey_GamepadR1);
+            gamepad(RE::BSWin32GamepadDevice::Key::kA, ImGuiKey_GamepadFaceDown);
+            gamepad(RE::BSWin32GamepadDevice::Key::kB, ImGuiKey_GamepadFaceRight);
+            gamepad(RE::BSWin32GamepadDevice::Key::kX, ImGuiKey_GamepadFaceLeft);
+            gamepad(RE::BSWin32GamepadDevice::Key::kY, ImGuiKey_GamepadFaceUp);
+            return table;
+        }();
 
-        inline ImGuiKey ParseKeyFromGamepad(std::uint32_t a_key)
+        [[nodiscard]] inline ImGuiKey KeycodeToImGuiKey(std::uint32_t a_key) noexcept
         {
-            return ParseKeyFromGamepad(static_cast<RE::BSWin32GamepadDevice::Key>(a_key));
-        }
-
-        inline void TranslateButtonEvent(ImGuiIO& a_io, const RE::ButtonEvent* a_button)
-        {
-            if (!a_button->HasIDCode()) {
-                return;
-            }
-
-            switch (a_button->GetDevice()) {
-            case RE::INPUT_DEVICE::kKeyboard:
-                {
-                    auto imKey = ImGui::ParseKeyFromKeyboard(a_button->GetIDCode());
-                    a_io.AddKeyEvent(imKey, a_button->IsPressed());
-                }
-                break;
-            case RE::INPUT_DEVICE::kMouse:
-                {
-                    auto key = static_cast<RE::BSWin32MouseDevice::Key>(a_button->GetIDCode());
-                    switch (key) {
-                    case RE::BSWin32MouseDevice::Key::kWheelUp:
-                        a_io.AddMouseWheelEvent(0, a_button->Value());
-                        break;
-                    case RE::BSWin32MouseDevice::Key::kWheelDown:
-                        a_io.AddMouseWheelEvent(0, a_button->Value() * -1);
-                        break;
-                    default:
-                        a_io.AddMouseButtonEvent(key, a_button->IsPressed());
-                        break;
-                    }
-                }
-                break;
-            case RE::INPUT_DEVICE::kGamepad:
-                {
-                    auto imKey = ImGui::ParseKeyFromGamepad(a_button->GetIDCode());
-                    a_io.AddKeyEvent(imKey, a_button->IsPressed());
-                }
-                break;
-            default:
-                break;
-            }
+            return a_key < kKeys.size() ? kKeys[a_key] : ImGuiKey_None;
         }
     }
 
-    void TranslateInputEvent(const RE::InputEvent* const* a_event)
+    void TranslateButtonEvent(std::uint32_t a_key, bool a_pressed, float a_value)
     {
         auto& io = ImGui::GetIO();
-        for (auto event = *a_event; event; event = event->next) {
-            if (auto button = event->AsButtonEvent()) {
-                TranslateButtonEvent(io, button);
-            } else if (auto charEvent = event->AsCharEvent()) {
-                io.AddInputCharacter(charEvent->keycode);
+        if (a_key >= SKSE::InputMap::kMacro_MouseButtonOffset && a_key < SKSE::InputMap::kMacro_MouseWheelOffset) {
+            auto button = static_cast<int>(a_key - SKSE::InputMap::kMacro_MouseButtonOffset);
+            if (button < ImGuiMouseButton_COUNT) {
+                io.AddMouseButtonEvent(button, a_pressed);
             }
+        } else if (a_key == SKSE::InputMap::kMacro_MouseWheelOffset) {
+            io.AddMouseWheelEvent(0, a_value);
+        } else if (a_key == SKSE::InputMap::kMacro_MouseWheelOffset + 1) {
+            io.AddMouseWheelEvent(0, a_value * -1);
+        } else if (auto imKey = KeycodeToImGuiKey(a_key); imKey != ImGuiKey_None) {
+            io.AddKeyEvent(imKey, a_pressed);
         }
     }
 
+    void TranslateCharEvent(std::uint32_t a_char) { ImGui::GetIO().AddInputCharacter(a_char); }
+
+    void CommitInputEvent() noexcept { inputVersion.fetch_add(1); }
+
     void ClearInputEvent()
     {
         auto& io = ImGui::GetIO();
         io.ClearEventsQueue();
         io.ClearInputKeys();
         io.ClearInputMouse();
+        inputVersion.fetch_add(1);
     }
+
+    std::uint32_t InputVersion() noexcept { return inputVersion.load(); }
 }
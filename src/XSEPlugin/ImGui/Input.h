@@ -2,6 +2,22 @@
 
 namespace ImGui
 {
-    void TranslateInputEvent(const RE::InputEvent* const* a_event);
+    /// Queue a button event to ImGui.
+    ///
+    /// @param a_key
+    ///   Keycode of button, as returned by CLib::ParseKey.
+    /// @param a_value
+    ///   Value of button, which is the delta of mouse wheel.
+    void TranslateButtonEvent(std::uint32_t a_key, bool a_pressed, float a_value);
+
+    /// Queue a char event to ImGui.
+    void TranslateCharEvent(std::uint32_t a_char);
+
+    /// Mark the events queued since last call as new input.
+    void CommitInputEvent() noexcept;
+
     void ClearInputEvent();
+
+    /// Increase whenever input events are translated or cleared.
+    [[nodiscard]] std::uint32_t InputVersion() noexcept;
 }
@@ -3,10 +3,27 @@
 #include <imgui.h>
 #include <imgui_internal.h>
 
+#include <XSEPlugin/Base/Configuration.h>
 #include <XSEPlugin/ImGui/Renderer.h>
 
 namespace ImGui
 {
+    namespace
+    {
+        // Results beyond this are not useful to scroll through.
+        constexpr std::size_t kSearchLimit = 100;
+
+        inline bool IsSearchEnabled()
+        {
+            return Configuration::GetSingleton()->explorer.bSearch;
+        }
+
+        inline ImGuiTabItemFlags SelectFlags(const MFM_Tree* a_tree, const MFM_Tree* a_selected)
+        {
+            return a_tree == a_selected ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
+        }
+    }
+
     void Menu::Open()
     {
         Renderer::GetSingleton()->Enable();
@@ -16,8 +33,15 @@ namespace ImGui
 
     void Menu::Close()
     {
-        _isOpen.store(false);
+        // Functions invoked by hotkeys may close the menu that is not open.
+        if (!_isOpen.exchange(false)) {
+            return;
+        }
         SKSE::log::trace("Close menu.");
+
+        Executor::GetSingleton()->CancelPending();
+
+        Datastore::GetSingleton()->SaveIndex();
     }
 
     void Menu::Draw()
@@ -37,19 +61,31 @@ namespace ImGui
 
         ImGui::Begin(texts.Title.c_str(), nullptr, window_flags);
         {
+            if (IsSearchEnabled()) {
+                DrawSearchBox(datastore);
+            }
+
             ImGuiTabBarFlags tab_bar_flags = ImGuiTabBarFlags_None;
             if (ImGui::BeginTabBar("TabBar", tab_bar_flags)) {
-                if (ImGui::BeginTabItem(texts.Section_Mod.c_str())) {
+                auto selected = std::exchange(_selectSection, nullptr);
+                if (ImGui::BeginTabItem(texts.Section_Mod.c_str(), nullptr,
+                        SelectFlags(std::addressof(datastore->modTree), selected))) {
                     datastore->CurrentSection(datastore->modTree);
                     ImGui::EndTabItem();
                 }
-                if (ImGui::BeginTabItem(texts.Section_Config.c_str())) {
+                if (ImGui::BeginTabItem(texts.Section_Config.c_str(), nullptr,
+                        SelectFlags(std::addressof(datastore->configTree), selected))) {
                     datastore->CurrentSection(datastore->configTree);
                     ImGui::EndTabItem();
                 }
                 ImGui::EndTabBar();
             }
-            DrawExplorer(datastore);
+
+            if (_query.front() != '\0') {
+                DrawSearchResults(datastore);
+            } else {
+                DrawExplorer(datastore);
+            }
         }
         ImGui::End();
 
@@ -58,30 +94,187 @@ namespace ImGui
 #endif
     }
 
+    void Menu::InvokeHotkey(const MFM_HotkeyBinding& a_binding)
+    {
+        {
+            std::scoped_lock lock{ _hotkeyMutex };
+            _hotkeyQueue.push_back(a_binding);
+        }
+        _hotkeyPending.store(true);
+    }
+
+    bool Menu::ProcessCompletions()
+    {
+        bool invoked = false;
+        if (_hotkeyPending.exchange(false)) {
+            std::vector<MFM_HotkeyBinding> queue;
+            {
+                std::scoped_lock lock{ _hotkeyMutex };
+                queue.swap(_hotkeyQueue);
+            }
+            for (const auto& binding : queue) {
+                SKSE::log::debug("Invoke \"{}\" by hotkey \"{}\".", binding.path, binding.func->hotkey);
+                Invoke(binding.tree, binding.path, binding.func, true);
+            }
+            invoked = !queue.empty();
+        }
+
+        // Called every frame even if the menu is closed, so nothing is
+        // touched unless a function is running.
+        if (_running.empty()) {
+            return invoked;
+        }
+
+        auto completions = Executor::GetSingleton()->Drain();
+        for (auto& completion : completions) {
+            auto it = _running.find(completion.id);
+            if (it == _running.end()) {
+                continue;
+            }
+            auto tree = it->second.tree;
+            auto byHotkey = it->second.byHotkey;
+            _running.erase(it);
+
+            const auto& func = *completion.func;
+            if (completion.cancelled) {
+                continue;
+            }
+            if (!completion.error.empty()) {
+                SKSE::log::error("Failed to invoke function: dll = \"{}\", api = \"{}\": {}.", func.dll, func.api,
+                    completion.error);
+                continue;
+            }
+
+            if (func.type != MFMAPI_Type::kVoid) {
+                SetMessage(std::move(completion.msg));
+                _openMessageBox = true;
+                if (byHotkey) {
+                    Open();
+                }
+            }
+            ApplyPostAction(tree, func.postAction);
+        }
+        return invoked || !completions.empty();
+    }
+
+    void Menu::DrawSearchBox(Datastore* datastore)
+    {
+        auto renderer = Renderer::GetSingleton();
+
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        ImGui::InputTextWithHint("##Search", renderer->texts.Search.c_str(), _query.data(), _query.size());
+
+        std::string_view query{ _query.data() };
+        renderer->fonts.Feed(query);
+
+        // Query only when it changes, or index catches up with filesystem.
+        auto version = datastore->SearchVersion();
+        if (query != _lastQuery || version != _lastSearchVersion) {
+            _lastQuery = query;
+            _lastSearchVersion = version;
+            _results = query.empty() ? std::vector<MFM_SearchResult>{} : datastore->Search(query, kSearchLimit);
+        }
+    }
+
+    void Menu::DrawSearchResults(Datastore* datastore)
+    {
+        auto renderer = Renderer::GetSingleton();
+
+        ImGui::Spacing();
+
+        if (ImGui::BeginTable("Explorer", 1)) {
+            ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2{ 0.0f, 0.0f });
+
+            ImVec2 sz = ImVec2(-FLT_MIN, 0.0f);
+
+            // Clicking may clear results.
+            const MFM_SearchResult* clicked = nullptr;
+            for (const auto& result : _results) {
+                ImGui::TableNextColumn();
+                const auto& label = result.label;
+                renderer->fonts.Feed(label);
+                if (!_running.empty() && IsRunning(result.tree, result.path)) {
+                    renderer->fonts.Feed(renderer->texts.Running);
+                    ImGui::BeginDisabled();
+                    ImGui::Button(RunningLabel(label), sz);
+                    ImGui::EndDisabled();
+                    continue;
+                }
+                if (ImGui::Button(label.c_str(), sz)) {
+                    clicked = std::addressof(result);
+                }
+            }
+            if (clicked) {
+                OnClickSearchResult(*clicked);
+            }
+
+            DrawMessageBox(datastore);
+
+            ImGui::PopStyleVar();
+            ImGui::EndTable();
+        }
+    }
+
     void Menu::DrawExplorer(Datastore* datastore)
     {
         auto renderer = Renderer::GetSingleton();
 
         auto tree = datastore->CurrentSection();
+        tree->Sync();
+
+        // Feed glyphs of all children at once when directory is displayed.
+        auto pathVersion = tree->CurrentPathVersion();
+        auto fontsVersion = renderer->fonts.Version();
+        if (tree != _fedTree || pathVersion != _fedPathVersion || fontsVersion != _fedFontsVersion) {
+            _fedTree = tree;
+            _fedPathVersion = pathVersion;
+            _fedFontsVersion = fontsVersion;
+            renderer->fonts.Feed(tree->Snapshot().Glyphs(tree->CurrentPath()));
+        }
+
         ImGui::Text("%s", tree->CurrentPathStr().c_str());
         ImGui::Spacing();
 
-        if (ImGui::BeginTable("Explorer", 1)) {
+        // Scroll within table, so that rows out of view can be clipped.
+        if (ImGui::BeginTable("Explorer", 1, ImGuiTableFlags_ScrollY)) {
             ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2{ 0.0f, 0.0f });
 
             ImVec2 sz = ImVec2(-FLT_MIN, 0.0f);
 
-            ImGui::TableNextColumn();
-            if (ImGui::Button("..", sz)) {
-                OnClickParentEntry(tree);
+            const auto& snapshot = tree->Snapshot();
+            auto        children = snapshot.Children(tree->CurrentPath());
+            auto        childCount = static_cast<int>(children.size());
+
+            // Row 0 is parent entry, followed by children, then a placeholder while they are enumerated.
+            auto rowCount = childCount + 1 + (tree->IsExpanding() ? 1 : 0);
+            if (_focusedRow >= rowCount) {
+                _focusedRow = -1;
             }
 
-            auto node = tree->CurrentPath();
-            for (auto& entry : node->children) {
-                ImGui::TableNextColumn();
-                renderer->fonts.Feed(entry->name);
-                if (ImGui::Button(entry->name.c_str(), sz)) {
-                    OnClickEntry(tree, entry.get());
+            ImGuiListClipper clipper;
+            clipper.Begin(rowCount);
+            if (_focusedRow >= 0) {
+                // Keep focused row alive while scrolled out of view, so that navigation does not lose it.
+                clipper.IncludeItemByIndex(_focusedRow);
+            }
+            while (clipper.Step()) {
+                for (auto row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                    ImGui::TableNextColumn();
+                    if (row == 0) {
+                        if (ImGui::Button("..", sz)) {
+                            OnClickParentEntry(tree);
+                        }
+                    } else if (row <= childCount) {
+                        DrawExplorerEntry(tree, children[row - 1], sz);
+                    } else {
+                        renderer->fonts.Feed(renderer->texts.Loading);
+                        ImGui::BeginDisabled();
+                        ImGui::Button(renderer->texts.Loading.c_str(), sz);
+                        ImGui::EndDisabled();
+                    }
+                    if (ImGui::IsItemFocused()) {
+                        _focusedRow = row;
+                    }
                 }
             }
 
@@ -92,13 +285,50 @@ namespace ImGui
         }
     }
 
+    void Menu::DrawExplorerEntry(MFM_Tree* a_tree, MFM_NodeID a_id, const ImVec2& a_size)
+    {
+        auto renderer = Renderer::GetSingleton();
+
+        const auto& snapshot = a_tree->Snapshot();
+
+        auto name = snapshot.Name(a_id);
+        if (!_running.empty() && IsRunning(a_tree, snapshot.RelativePath(a_id))) {
+            renderer->fonts.Feed(renderer->texts.Running);
+            ImGui::BeginDisabled();
+            ImGui::Button(RunningLabel(name), a_size);
+            ImGui::EndDisabled();
+            return;
+        }
+        ImGui::BeginDisabled(a_tree->IsUnavailable(a_id));
+        if (ImGui::Button(name.data(), a_size)) {
+            OnClickEntry(a_tree, a_id);
+        }
+        ImGui::EndDisabled();
+    }
+
     void Menu::DrawMessageBox(Datastore* datastore)
     {
         ImVec2 center = ImGui::GetMainViewport()->GetCenter();
         ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
 
+        if (_openMessageBox) {
+            ImGui::OpenPopup("MessageBox");
+            _openMessageBox = false;
+        }
+
         if (ImGui::BeginPopupModal("MessageBox", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
-            ImGui::Text("%s", _msg.data());
+            // Long message scrolls within a bounded region.
+            if (_msgSize.x < 0.0f) {
+                _msgSize = ImGui::CalcTextSize(_msg.data(), _msg.data() + _msg.size());
+            }
+            const auto& style = ImGui::GetStyle();
+            auto        viewport = ImGui::GetMainViewport();
+            ImVec2      size{ std::min(_msgSize.x + style.ScrollbarSize, viewport->Size.x * 0.6f),
+                std::min(_msgSize.y + style.ScrollbarSize, viewport->Size.y * 0.6f) };
+            if (ImGui::BeginChild("Message", size, ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar)) {
+                ImGui::TextUnformatted(_msg.data(), _msg.data() + _msg.size());
+            }
+            ImGui::EndChild();
             ImGui::Spacing();
 
             if (ImGui::Button("OK", ImVec2(120, 0))) {
@@ -116,68 +346,146 @@ namespace ImGui
 
     void Menu::OnClickParentEntry(MFM_Tree* a_tree) { a_tree->ResetCurrentPathToParent(); }
 
-    void Menu::OnClickEntry(MFM_Tree* a_tree, const MFM_Node* a_node)
+    void Menu::OnClickEntry(MFM_Tree* a_tree, MFM_NodeID a_id)
     {
-        switch (a_node->type) {
+        const auto& snapshot = a_tree->Snapshot();
+        switch (snapshot[a_id].type) {
         case MFM_Node::Type::kRegular:
-            {
-                auto func = MFM_Function::Get(a_node->path);
-
-                switch (func.preAction) {
-                case MFMAPI_PreAction::kNone:
-                    break;
-                case MFMAPI_PreAction::kCloseMenu:
-                    Close();
-                    break;
-                case MFMAPI_PreAction::kCloseMenuAndResetPath:
-                    Close();
-                    a_tree->ResetCurrentPath();
-                    break;
-                }
-
-                InvokeFunction(func);
-
-                switch (func.postAction) {
-                case MFMAPI_PostAction::kNone:
-                    break;
-                case MFMAPI_PostAction::kCloseMenu:
-                    Close();
-                    break;
-                case MFMAPI_PostAction::kCloseMenuAndResetPath:
-                    Close();
-                    a_tree->ResetCurrentPath();
-                    break;
-                }
-            }
+            Invoke(a_tree, snapshot.RelativePath(a_id), a_tree->Function(a_id), false);
             break;
         case MFM_Node::Type::kDirectory:
             {
-                a_tree->CurrentPath(a_node);
+                a_tree->CurrentPath(a_id);
             }
             break;
         }
     }
 
-    void Menu::InvokeFunction(const MFM_Function& a_func)
+    void Menu::OnClickSearchResult(const MFM_SearchResult& a_result)
     {
-        switch (a_func.type) {
-        case MFMAPI_Type::kVoid:
-            SKSE::log::debug("Invoke Void function.");
-            a_func();
+        auto tree = a_result.tree;
+        tree->Sync();
+
+        // Node may have gone since indexed.
+        auto id = tree->Snapshot().FindPath(a_result.path);
+        if (id == MFM_Snapshot::root) {
+            SKSE::log::debug("Search result \"{}\" no longer exists.", a_result.label);
+            return;
+        }
+
+        switch (tree->Snapshot()[id].type) {
+        case MFM_Node::Type::kRegular:
+            OnClickEntry(tree, id);
             break;
-        case MFMAPI_Type::kMessage:
-            SKSE::log::debug("Invoke Message function.");
-            // TODO
-        case MFMAPI_Type::kMessageBox:
-            SKSE::log::debug("Invoke MessageBox function.");
-            {
-                _msg.resize(0x4000);
-                a_func(_msg.data(), _msg.size());
-                _msg.back() = '\0';
+        case MFM_Node::Type::kDirectory:
+            // Leave search and show the directory.
+            tree->CurrentPath(id);
+            _selectSection = tree;
+            _query.fill('\0');
+            break;
+        }
+    }
 
-                ImGui::OpenPopup("MessageBox");
+    void Menu::Invoke(MFM_Tree* a_tree, std::string_view a_path, const std::shared_ptr<const MFM_Function>& a_func,
+        bool a_byHotkey)
+    {
+        // Functions not prefetched are only resolved now.
+        if (!a_func->IsAvailable()) {
+            SKSE::log::warn("Function is not available: dll = \"{}\", api = \"{}\".", a_func->dll, a_func->api);
+            SetMessage(std::format("\"{}\" is not available: \"{}\" is not loaded or does not export \"{}\".",
+                a_path, a_func->dll, a_func->api));
+            _openMessageBox = true;
+            if (a_byHotkey) {
+                Open();
             }
+            return;
+        }
+
+        switch (a_func->preAction) {
+        case MFMAPI_PreAction::kNone:
+            break;
+        case MFMAPI_PreAction::kCloseMenu:
+            Close();
+            break;
+        case MFMAPI_PreAction::kCloseMenuAndResetPath:
+            Close();
+            a_tree->ResetCurrentPath();
+            break;
+        }
+
+        if (a_func->thread == MFMAPI_Thread::kWorker) {
+            // Post action is applied on completion.
+            auto id = Executor::GetSingleton()->Submit(a_func);
+            _running.emplace(id, RunningEntry{ a_tree, std::string{ a_path }, a_byHotkey });
+            return;
+        }
+
+        // Called from Present hook, which must not throw to game.
+        try {
+            InvokeFunction(*a_func);
+        } catch (const std::exception& e) {
+            SKSE::log::error("Failed to invoke function: dll = \"{}\", api = \"{}\": {}.", a_func->dll, a_func->api,
+                e.what());
+            SetMessage(std::format("Failed to invoke \"{}\": {}.", a_path, e.what()));
+            _openMessageBox = true;
+            if (a_byHotkey) {
+                Open();
+            }
+            return;
+        }
+        if (a_byHotkey && a_func->type != MFMAPI_Type::kVoid) {
+            // Show message.
+            Open();
+        }
+        ApplyPostAction(a_tree, a_func->postAction);
+    }
+
+    void Menu::InvokeFunction(const MFM_Function& a_func)
+    {
+        SKSE::log::debug("Invoke {} function.", MFMAPI_Type_EnumToStr(a_func.type));
+
+        // Message is shown in MessageBox as well.
+        auto msg = a_func.Invoke();
+        if (a_func.type != MFMAPI_Type::kVoid) {
+            SetMessage(std::move(msg));
+            _openMessageBox = true;
+        }
+    }
+
+    void Menu::ApplyPostAction(MFM_Tree* a_tree, MFMAPI_PostAction a_postAction)
+    {
+        switch (a_postAction) {
+        case MFMAPI_PostAction::kNone:
+            break;
+        case MFMAPI_PostAction::kCloseMenu:
+            Close();
+            break;
+        case MFMAPI_PostAction::kCloseMenuAndResetPath:
+            Close();
+            a_tree->ResetCurrentPath();
             break;
         }
     }
+
+    void Menu::SetMessage(std::string a_msg)
+    {
+        _msg = std::move(a_msg);
+        _msgSize = ImVec2{ -1.0f, -1.0f };
+    }
+
+    const char* Menu::RunningLabel(std::string_view a_name)
+    {
+        // Reuse buffer, so that drawing running entries allocates nothing.
+        _label.clear();
+        const auto& running = Renderer::GetSingleton()->texts.Running;
+        std::format_to(std::back_inserter(_label), "{} {}###{}", a_name, running, a_name);
+        return _label.c_str();
+    }
+
+    bool Menu::IsRunning(const MFM_Tree* a_tree, std::string_view a_path) const
+    {
+        return std::ranges::any_of(_running, [&](const auto& a_pair) {
+            return a_pair.second.tree == a_tree && a_pair.second.path == a_path;
+        });
+    }
 }
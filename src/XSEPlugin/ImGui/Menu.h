@@ -1,6 +1,9 @@
 #pragma once
 
+#include <imgui.h>
+
 #include <XSEPlugin/Core.h>
+#include <XSEPlugin/Executor.h>
 #include <XSEPlugin/Util/Singleton.h>
 
 namespace ImGui
@@ -17,21 +20,83 @@ namespace ImGui
 
         void Draw();
 
+        /// Invoke the function of a hotkey on next frame, whether the menu is
+        /// open or not. The menu is opened to show its message, if any.
+        ///
+        /// @note
+        ///   Thread-safe.
+        void InvokeHotkey(const MFM_HotkeyBinding& a_binding);
+
+        /// Invoke functions of hotkeys, and apply completions of worker
+        /// functions.
+        ///
+        /// @return
+        ///   True if any function was invoked or completed.
+        bool ProcessCompletions();
+
     private:
+        /// A worker function that is queued or running.
+        struct RunningEntry
+        {
+            MFM_Tree*   tree;
+            std::string path;  // Relative to tree root.
+            bool        byHotkey;
+        };
+
         Menu() = default;
 
         ~Menu() = default;
 
+        void DrawSearchBox(Datastore* datastore);
+        void DrawSearchResults(Datastore* datastore);
         void DrawExplorer(Datastore* datastore);
+        void DrawExplorerEntry(MFM_Tree* a_tree, MFM_NodeID a_id, const ImVec2& a_size);
         void DrawMessageBox(Datastore* datastore);
 
         void OnClickParentEntry(MFM_Tree* a_tree);
-        void OnClickEntry(MFM_Tree* a_tree, const MFM_Node* a_node);
+        void OnClickEntry(MFM_Tree* a_tree, MFM_NodeID a_id);
+        void OnClickSearchResult(const MFM_SearchResult& a_result);
+
+        /// Apply pre-action, then invoke function on its thread.
+        void Invoke(MFM_Tree* a_tree, std::string_view a_path, const std::shared_ptr<const MFM_Function>& a_func,
+            bool a_byHotkey);
 
         void InvokeFunction(const MFM_Function& a_func);
 
+        void ApplyPostAction(MFM_Tree* a_tree, MFMAPI_PostAction a_postAction);
+
+        /// Set message of MessageBox.
+        void SetMessage(std::string a_msg);
+
+        /// The label of a running entry, valid until next call.
+        [[nodiscard]] const char* RunningLabel(std::string_view a_name);
+
+        [[nodiscard]] bool IsRunning(const MFM_Tree* a_tree, std::string_view a_path) const;
+
         std::atomic<bool> _isOpen{ false };
 
-        std::vector<char> _msg;
+        std::string _msg;
+        ImVec2      _msgSize{ -1.0f, -1.0f };  // Measured on first draw.
+        bool        _openMessageBox{ false };
+
+        std::map<Executor::JobID, RunningEntry> _running;
+        std::string                             _label;  // Buffer of RunningLabel().
+
+        std::mutex                     _hotkeyMutex;
+        std::vector<MFM_HotkeyBinding> _hotkeyQueue;
+        std::atomic<bool>              _hotkeyPending{ false };
+
+        std::array<char, 0x100>       _query{};
+        std::string                   _lastQuery;
+        std::uint32_t                 _lastSearchVersion{ 0 };
+        std::vector<MFM_SearchResult> _results;
+        MFM_Tree*                     _selectSection{ nullptr };  // Select its tab on next frame.
+
+        int _focusedRow{ -1 };  // Row of explorer that has navigation focus.
+
+        // The directory whose glyphs were fed to fonts.
+        const MFM_Tree* _fedTree{ nullptr };
+        std::uint32_t   _fedPathVersion{ 0 };
+        std::uint32_t   _fedFontsVersion{ 0 };
     };
 }
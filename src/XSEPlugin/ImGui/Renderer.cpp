@@ -12,10 +12,54 @@
 #include <XSEPlugin/ImGui/Input.h>
 #include <XSEPlugin/ImGui/Menu.h>
 #include <XSEPlugin/InputManager.h>
+#include <XSEPlugin/Util/AllocStats.h>
 #include <XSEPlugin/Util/CLib/Hook.h>
 
 namespace ImGui
 {
+    namespace
+    {
+        // Hover delays and window auto-resizing take a few frames to settle
+        // after the last change.
+        constexpr auto kSettleTime = std::chrono::milliseconds{ 500 };
+
+        void* ImGuiAlloc(std::size_t a_size, [[maybe_unused]] void* a_userData)
+        {
+            AllocStats::Record(a_size);
+            return std::malloc(a_size);
+        }
+
+        void ImGuiFree(void* a_ptr, [[maybe_unused]] void* a_userData) { std::free(a_ptr); }
+
+        /// Whether ImGui is animating without input, such as text cursor
+        /// blinking, or acts on input held down, such as key repeat.
+        inline bool IsAnimating()
+        {
+            const auto& io = ImGui::GetIO();
+            if (io.WantTextInput || ImGui::IsAnyItemActive() || ImGui::IsAnyMouseDown()) {
+                return true;
+            }
+            for (auto key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; key = ImGuiKey(key + 1)) {
+                if (ImGui::IsKeyDown(key)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// The cursor position in client area, as the platform backend reads it
+        /// on new frame.
+        inline ImVec2 GetMousePos()
+        {
+            auto  window = static_cast<HWND>(ImGui::GetMainViewport()->PlatformHandleRaw);
+            POINT pos{};
+            if (!window || !::GetCursorPos(&pos) || !::ScreenToClient(window, &pos)) {
+                return ImVec2{ -FLT_MAX, -FLT_MAX };
+            }
+            return ImVec2{ static_cast<float>(pos.x), static_cast<float>(pos.y) };
+        }
+    }
+
     struct WndProcHook
     {
         static LRESULT thunk(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -92,6 +136,8 @@ namespace ImGui
         const auto device = (ID3D11Device*)renderer->data.forwarder;
         const auto context = (ID3D11DeviceContext*)renderer->data.context;
 
+        // Count allocations of ImGui along with those of this module.
+        ImGui::SetAllocatorFunctions(ImGuiAlloc, ImGuiFree);
         ImGui::CreateContext();
 
         auto& io = ImGui::GetIO();
@@ -126,14 +172,46 @@ namespace ImGui
 
     void Renderer::Run()
     {
-        if (!IsInit() || !IsEnable()) {
+        if (!IsInit()) {
+            return;
+        }
+        if (!IsEnable()) {
+            // Functions invoked by hotkeys run while the menu is closed.
+            Menu::GetSingleton()->ProcessCompletions();
             return;
         }
 
+        using Phase = Impl::FrameStats::Phase;
+
+        frameStats.Begin();
+
+        auto changed = Menu::GetSingleton()->ProcessCompletions();
+        frameStats.Mark(Phase::kCompletions);
+
         if (Configuration::IsVersionChanged(_configVersion) || Translation::IsVersionChanged(_transVersion)) {
             Load();
+            changed = true;
+            frameStats.Mark(Phase::kLoad);
         } else {
-            fonts.Refresh();
+            changed |= fonts.Refresh();
+            frameStats.Mark(Phase::kFonts);
+        }
+
+        if (!WantUpdate(changed)) {
+            // Nothing changed, draw the previous frame again.
+            auto drawData = ImGui::GetDrawData();
+            ImGui_ImplDX11_RenderDrawData(drawData);
+            frameStats.Mark(Phase::kRenderDrawData);
+            frameStats.Count(drawData->TotalVtxCount);
+            if (auto allocs = frameStats.End(true); allocs.count > 0) {
+                // Counted by frame stats every time, warned once.
+                if (!std::exchange(_warnedIdleAlloc, true)) {
+                    SKSE::log::warn("Idle frame made {} allocations ({} bytes).", allocs.count, allocs.bytes);
+                } else {
+                    SKSE::log::debug("Idle frame made {} allocations ({} bytes).", allocs.count, allocs.bytes);
+                }
+            }
+            return;
         }
 
         ImGui_ImplDX11_NewFrame();
@@ -147,21 +225,31 @@ namespace ImGui
             io.DisplaySize.y = static_cast<float>(screenSize.height);
         }
         ImGui::NewFrame();
+        frameStats.Mark(Phase::kNewFrame);
         {
             if (auto menu = Menu::GetSingleton(); menu->IsOpen()) {
                 menu->Draw();
+                frameStats.DrawOverlay();
             } else {
                 Disable();
             }
         }
+        frameStats.Mark(Phase::kDraw);
         ImGui::EndFrame();
         ImGui::Render();
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        frameStats.Mark(Phase::kRender);
+        auto drawData = ImGui::GetDrawData();
+        ImGui_ImplDX11_RenderDrawData(drawData);
+        frameStats.Mark(Phase::kRenderDrawData);
+        frameStats.Count(drawData->TotalVtxCount);
+        frameStats.ConsumeInput();
+        frameStats.End();
     }
 
     void Renderer::Enable() noexcept
     {
         InputBlocker::SetBlocked();
+        _wantUpdate.store(true);
         _isEnable.store(true);
     }
 
@@ -173,19 +261,62 @@ namespace ImGui
 
     void Renderer::Load()
     {
-        std::shared_lock configLock{ Configuration::Mutex() };
-        std::shared_lock transLock{ Translation::Mutex() };
-
-        fonts.Load();
-        styles.Load();
-        texts.Load();
-
+        // Versions first, so that a snapshot published meanwhile is loaded next frame.
         _configVersion = Configuration::Version();
         _transVersion = Translation::Version();
 
+        auto config = Configuration::GetSingleton();
+        auto trans = Translation::GetSingleton();
+
+        fonts.Load(*config, *trans);
+        styles.Load(*config);
+        texts.Load(*trans);
+
+        const auto& cfgRenderer = config->renderer;
+        _skipIdleFrames = cfgRenderer.bSkipIdleFrames;
+        _updateInterval = cfgRenderer.iMaxUpdateRate > 0 ?
+                              std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double>{ 1.0 / cfgRenderer.iMaxUpdateRate }) :
+                              Clock::duration::zero();
+        frameStats.Enable(cfgRenderer.bFrameStats);
+
         SKSE::log::debug("Renderer: Upgrade to Configuration Version {}.", _configVersion);
         SKSE::log::debug("Renderer: Upgrade to Translation Version {}.", _transVersion);
     }
 
     Renderer Renderer::_singleton;
+
+    bool Renderer::WantUpdate(bool a_changed)
+    {
+        auto now = Clock::now();
+
+        auto inputVersion = InputVersion();
+        auto changeVersion = Datastore::GetSingleton()->ChangeVersion();
+        auto mousePos = GetMousePos();
+        if (a_changed || _wantUpdate.exchange(false) || inputVersion != _inputVersion ||
+            changeVersion != _changeVersion || mousePos.x != _mousePos.x || mousePos.y != _mousePos.y ||
+            IsAnimating()) {
+            _inputVersion = inputVersion;
+            _changeVersion = changeVersion;
+            _mousePos = mousePos;
+            _activeUntil = now + kSettleTime;
+        }
+
+        // Closing menu takes a frame, and there may be nothing to draw again
+        // yet. Changes by caller may also release textures of previous frame.
+        if (a_changed || !Menu::GetSingleton()->IsOpen() || !ImGui::GetDrawData()) {
+            _lastUpdate = now;
+            return true;
+        }
+
+        if (_updateInterval > Clock::duration::zero() && now - _lastUpdate < _updateInterval) {
+            return false;
+        }
+        if (_skipIdleFrames && now >= _activeUntil) {
+            return false;
+        }
+
+        _lastUpdate = now;
+        return true;
+    }
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <imgui.h>
+
 #include <XSEPlugin/ImGui/Impl/Fonts.h>
+#include <XSEPlugin/ImGui/Impl/FrameStats.h>
 #include <XSEPlugin/ImGui/Impl/Styles.h>
 #include <XSEPlugin/ImGui/Impl/Texts.h>
 
@@ -31,6 +34,8 @@ namespace ImGui
         Impl::Styles styles;
         Impl::Texts  texts;
 
+        Impl::FrameStats frameStats;
+
     private:
         Renderer() = default;
 
@@ -38,6 +43,13 @@ namespace ImGui
 
         void Load();
 
+        /// Whether a new frame must be built, or the previous one can be drawn
+        /// again as nothing has changed since.
+        ///
+        /// @param a_changed
+        ///   Whether state was changed by caller since last frame.
+        [[nodiscard]] bool WantUpdate(bool a_changed);
+
         static Renderer _singleton;
 
         std::atomic<bool> _isInit{ false };
@@ -45,5 +57,19 @@ namespace ImGui
 
         std::uint32_t _configVersion{ 0 };
         std::uint32_t _transVersion{ 0 };
+
+        // Idle frame skipping.
+        using Clock = std::chrono::steady_clock;
+
+        bool              _skipIdleFrames{ true };
+        Clock::duration   _updateInterval{ 0 };  // Zero if not capped.
+        std::atomic<bool> _wantUpdate{ true };   // Forced on next frame.
+        Clock::time_point _lastUpdate;
+        Clock::time_point _activeUntil;  // Keep updating until then, so that ImGui settles.
+        std::uint32_t     _inputVersion{ 0 };
+        std::uint32_t     _changeVersion{ 0 };
+        ImVec2            _mousePos{ -FLT_MAX, -FLT_MAX };
+
+        bool _warnedIdleAlloc{ false };
     };
 }
@@ -0,0 +1,394 @@
+#include "Index.h"
+
+#include <XSEPlugin/Util/Binary.h>
+
+namespace
+{
+    [[nodiscard]] inline std::int64_t ToRep(std::filesystem::file_time_type a_time) noexcept
+    {
+        return static_cast<std::int64_t>(a_time.time_since_epoch().count());
+    }
+
+    [[nodiscard]] inline std::filesystem::file_time_type FromRep(std::int64_t a_rep) noexcept
+    {
+        return std::filesystem::file_time_type{ std::filesystem::file_time_type::duration{ a_rep } };
+    }
+
+    /// Whether enum read from file is a known value.
+    template <class E, class ToStr, class ToEnum>
+    [[nodiscard]] bool IsKnown(std::uint32_t a_value, ToStr a_toStr, ToEnum a_toEnum)
+    {
+        auto value = static_cast<E>(a_value);
+        return a_toEnum(a_toStr(value)) == value;
+    }
+
+    /// Strings of index file being written.
+    class StringTable
+    {
+    public:
+        MFM_StringRef Add(std::string_view a_str)
+        {
+            MFM_StringRef ref{ static_cast<std::uint32_t>(_data.size()), static_cast<std::uint32_t>(a_str.size()) };
+            _data.append(a_str);
+            return ref;
+        }
+
+        const std::string& data() const noexcept { return _data; }
+
+    private:
+        std::string _data;
+    };
+}
+
+Index::Index() { Load(); }
+
+std::optional<MFM_Listing> Index::FindListing(const std::filesystem::path& a_path,
+    const MFM_Fingerprint& a_fingerprint) const
+{
+    auto key = PathToStr(a_path);
+
+    std::shared_lock lock{ _mutex };
+
+    if (auto it = _newDirs.find(key); it != _newDirs.end()) {
+        if (it->second.fingerprint != a_fingerprint) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    if (auto record = FindDir(key);
+        record && record->mtime == ToRep(a_fingerprint.mtime) && record->count == a_fingerprint.count) {
+        return ToListing(*record);
+    }
+    return std::nullopt;
+}
+
+void Index::PutListing(const std::filesystem::path& a_path, const MFM_Listing& a_listing)
+{
+    auto key = PathToStr(a_path);
+
+    std::unique_lock lock{ _mutex };
+    _newDirs.insert_or_assign(std::move(key), a_listing);
+    ++_putCount;
+}
+
+std::optional<MFM_Function> Index::FindFunction(const std::filesystem::path& a_path,
+    const MFM_FileStamp& a_stamp) const
+{
+    auto key = PathToStr(a_path);
+
+    std::shared_lock lock{ _mutex };
+
+    if (auto it = _newFuncs.find(key); it != _newFuncs.end()) {
+        if (it->second.stamp != a_stamp) {
+            return std::nullopt;
+        }
+        return it->second.func;
+    }
+
+    if (auto record = FindFunc(key);
+        record && record->mtime == ToRep(a_stamp.mtime) && record->size == a_stamp.size) {
+        return ToFunction(*record);
+    }
+    return std::nullopt;
+}
+
+void Index::PutFunction(const std::filesystem::path& a_path, const MFM_FileStamp& a_stamp, const MFM_Function& a_func)
+{
+    auto key = PathToStr(a_path);
+
+    std::unique_lock lock{ _mutex };
+    _newFuncs.insert_or_assign(std::move(key), FuncValue{ a_stamp, a_func });
+    ++_putCount;
+}
+
+std::vector<std::string> Index::FindHotkeyFunctions() const
+{
+    std::vector<std::string> paths;
+
+    std::shared_lock lock{ _mutex };
+
+    for (const auto& [key, value] : _newFuncs) {
+        if (!value.func.hotkey.empty()) {
+            paths.push_back(key);
+        }
+    }
+    for (const auto& record : _funcs) {
+        auto key = String(record.key);
+        if (record.hotkey.size == 0 || !key || _newFuncs.contains(*key)) {
+            continue;
+        }
+        paths.emplace_back(*key);
+    }
+    std::ranges::sort(paths);
+    return paths;
+}
+
+void Index::Save()
+{
+    std::scoped_lock saveLock{ _saveMutex };
+
+    Image         image;
+    std::uint64_t putCount = 0;
+    {
+        std::shared_lock lock{ _mutex };
+        if (_newDirs.empty() && _newFuncs.empty()) {
+            return;
+        }
+        image = Serialize();
+        putCount = _putCount;
+    }
+
+    auto tmpPath = _path;
+    tmpPath += L".tmp"sv;
+
+    try {
+        Write(tmpPath, image);
+    } catch (const std::system_error& e) {
+        SKSE::log::warn("Failed to save index to \"{}\": {}.", PathToStr(_path),
+            SKSE::stl::ansi_to_utf8(e.what()).value_or(e.what()));
+        return;
+    } catch (const std::exception& e) {
+        SKSE::log::warn("Failed to save index to \"{}\": {}.", PathToStr(_path), e.what());
+        return;
+    }
+
+    std::unique_lock lock{ _mutex };
+
+    try {
+        // Mapped file cannot be replaced.
+        _file.Close();
+        std::filesystem::rename(tmpPath, _path);
+
+        // Records put while writing are not in the file. Keep them all until
+        // next save, they take precedence anyway.
+        if (_putCount == putCount) {
+            _newDirs.clear();
+            _newFuncs.clear();
+        }
+        SKSE::log::debug("Successfully saved index to \"{}\".", PathToStr(_path));
+    } catch (const std::system_error& e) {
+        SKSE::log::warn("Failed to save index to \"{}\": {}.", PathToStr(_path),
+            SKSE::stl::ansi_to_utf8(e.what()).value_or(e.what()));
+    }
+
+    // Map new index, or old one if saving failed.
+    Load();
+}
+
+void Index::Load()
+{
+    _dirs = {};
+    _entries = {};
+    _funcs = {};
+    _strings = {};
+
+    if (!_file.Open(_path.c_str())) {
+        SKSE::log::debug("Index \"{}\" is not available.", PathToStr(_path));
+        return;
+    }
+
+    auto data = _file.data();
+
+    std::size_t offset = 0;
+    auto        header = Binary::Take<Header>(data, offset, 1);
+    if (!header || header->front().magic != magic || header->front().version != version) {
+        SKSE::log::warn("Ignore index \"{}\": unknown format.", PathToStr(_path));
+        _file.Close();
+        return;
+    }
+
+    const auto& h = header->front();
+
+    auto dirs = Binary::Take<DirRecord>(data, offset, h.dirCount);
+    auto entries = Binary::Take<EntryRecord>(data, offset, h.entryCount);
+    auto funcs = Binary::Take<FuncRecord>(data, offset, h.funcCount);
+    auto strings = Binary::Take<char>(data, offset, h.stringSize);
+    if (!dirs || !entries || !funcs || !strings) {
+        SKSE::log::warn("Ignore index \"{}\": truncated.", PathToStr(_path));
+        _file.Close();
+        return;
+    }
+
+    _dirs = *dirs;
+    _entries = *entries;
+    _funcs = *funcs;
+    _strings = { strings->data(), strings->size() };
+
+    SKSE::log::debug("Load index \"{}\": {} directories, {} functions.", PathToStr(_path), _dirs.size(),
+        _funcs.size());
+}
+
+Index::Image Index::Serialize() const
+{
+    StringTable              strings;
+    std::vector<DirRecord>   dirs;
+    std::vector<EntryRecord> entries;
+    std::vector<FuncRecord>  funcs;
+
+    auto addDir = [&](std::string_view a_key, const MFM_Listing& a_listing) {
+        auto& record = dirs.emplace_back();
+        record.key = strings.Add(a_key);
+        record.mtime = ToRep(a_listing.fingerprint.mtime);
+        record.count = a_listing.fingerprint.count;
+        record.firstEntry = static_cast<std::uint32_t>(entries.size());
+        record.entryCount = static_cast<std::uint32_t>(a_listing.entries.size());
+        for (const auto& entry : a_listing.entries) {
+            entries.push_back({ strings.Add(entry.fileName), static_cast<std::uint32_t>(entry.type) });
+        }
+    };
+
+    auto addFunc = [&](std::string_view a_key, const FuncValue& a_value) {
+        auto& record = funcs.emplace_back();
+        record.key = strings.Add(a_key);
+        record.mtime = ToRep(a_value.stamp.mtime);
+        record.size = a_value.stamp.size;
+        record.dll = strings.Add(a_value.func.dll);
+        record.api = strings.Add(a_value.func.api);
+        record.type = static_cast<std::uint32_t>(a_value.func.type);
+        record.preAction = static_cast<std::uint32_t>(a_value.func.preAction);
+        record.postAction = static_cast<std::uint32_t>(a_value.func.postAction);
+        record.thread = static_cast<std::uint32_t>(a_value.func.thread);
+        record.hotkey = strings.Add(a_value.func.hotkey);
+    };
+
+    // Merge new records with old ones, both are sorted by key. Old records
+    // are kept even if not visited in this session, they are still validated
+    // when used.
+    {
+        auto it = _newDirs.begin();
+        for (const auto& record : _dirs) {
+            auto key = String(record.key);
+            if (!key) {
+                continue;
+            }
+            for (; it != _newDirs.end() && it->first < *key; ++it) {
+                addDir(it->first, it->second);
+            }
+            if (it != _newDirs.end() && it->first == *key) {
+                continue;
+            }
+            if (auto listing = ToListing(record)) {
+                addDir(*key, *listing);
+            }
+        }
+        for (; it != _newDirs.end(); ++it) {
+            addDir(it->first, it->second);
+        }
+    }
+    {
+        auto it = _newFuncs.begin();
+        for (const auto& record : _funcs) {
+            auto key = String(record.key);
+            if (!key) {
+                continue;
+            }
+            for (; it != _newFuncs.end() && it->first < *key; ++it) {
+                addFunc(it->first, it->second);
+            }
+            if (it != _newFuncs.end() && it->first == *key) {
+                continue;
+            }
+            if (auto func = ToFunction(record)) {
+                addFunc(*key, FuncValue{ { FromRep(record.mtime), record.size }, std::move(*func) });
+            }
+        }
+        for (; it != _newFuncs.end(); ++it) {
+            addFunc(it->first, it->second);
+        }
+    }
+
+    Image image{};
+    image.header.magic = magic;
+    image.header.version = version;
+    image.header.dirCount = static_cast<std::uint32_t>(dirs.size());
+    image.header.entryCount = static_cast<std::uint32_t>(entries.size());
+    image.header.funcCount = static_cast<std::uint32_t>(funcs.size());
+    image.header.stringSize = static_cast<std::uint32_t>(strings.data().size());
+    image.dirs = std::move(dirs);
+    image.entries = std::move(entries);
+    image.funcs = std::move(funcs);
+    image.strings = strings.data();
+    return image;
+}
+
+void Index::Write(const std::filesystem::path& a_path, const Image& a_image)
+{
+    std::ofstream file{ a_path, std::ios::binary | std::ios::trunc };
+    file.exceptions(std::ios::failbit | std::ios::badbit);
+
+    std::size_t offset = 0;
+    Binary::Put(file, offset, std::span<const Header>{ &a_image.header, 1 });
+    Binary::Put(file, offset, std::span<const DirRecord>{ a_image.dirs });
+    Binary::Put(file, offset, std::span<const EntryRecord>{ a_image.entries });
+    Binary::Put(file, offset, std::span<const FuncRecord>{ a_image.funcs });
+    Binary::Put(file, offset, std::span<const char>{ a_image.strings });
+}
+
+std::optional<std::string_view> Index::String(MFM_StringRef a_ref) const noexcept
+{
+    if (a_ref.offset > _strings.size() || a_ref.size > _strings.size() - a_ref.offset) {
+        return std::nullopt;
+    }
+    return _strings.substr(a_ref.offset, a_ref.size);
+}
+
+const Index::DirRecord* Index::FindDir(std::string_view a_key) const noexcept
+{
+    // Records are sorted by key.
+    auto it = std::ranges::lower_bound(_dirs, a_key, {},
+        [this](const DirRecord& a_record) { return String(a_record.key).value_or(""sv); });
+    return (it != _dirs.end() && String(it->key) == a_key) ? std::addressof(*it) : nullptr;
+}
+
+const Index::FuncRecord* Index::FindFunc(std::string_view a_key) const noexcept
+{
+    // Records are sorted by key.
+    auto it = std::ranges::lower_bound(_funcs, a_key, {},
+        [this](const FuncRecord& a_record) { return String(a_record.key).value_or(""sv); });
+    return (it != _funcs.end() && String(it->key) == a_key) ? std::addressof(*it) : nullptr;
+}
+
+std::optional<MFM_Listing> Index::ToListing(const DirRecord& a_record) const
+{
+    if (a_record.firstEntry > _entries.size() || a_record.entryCount > _entries.size() - a_record.firstEntry) {
+        return std::nullopt;
+    }
+
+    MFM_Listing listing;
+    listing.fingerprint.mtime = FromRep(a_record.mtime);
+    listing.fingerprint.count = a_record.count;
+    listing.entries.reserve(a_record.entryCount);
+    for (const auto& record : _entries.subspan(a_record.firstEntry, a_record.entryCount)) {
+        auto fileName = String(record.fileName);
+        if (!fileName || fileName->empty() || record.type > static_cast<std::uint32_t>(MFM_Node::Type::kDirectory)) {
+            return std::nullopt;
+        }
+        listing.entries.push_back({ std::string{ *fileName }, static_cast<MFM_Node::Type>(record.type) });
+    }
+    return listing;
+}
+
+std::optional<MFM_Function> Index::ToFunction(const FuncRecord& a_record) const
+{
+    auto dll = String(a_record.dll);
+    auto api = String(a_record.api);
+    auto hotkey = String(a_record.hotkey);
+    if (!dll || !api || !hotkey ||
+        !IsKnown<MFMAPI_Type>(a_record.type, MFMAPI_Type_EnumToStr, MFMAPI_Type_StrToEnum) ||
+        !IsKnown<MFMAPI_PreAction>(a_record.preAction, MFMAPI_PreAction_EnumToStr, MFMAPI_PreAction_StrToEnum) ||
+        !IsKnown<MFMAPI_PostAction>(a_record.postAction, MFMAPI_PostAction_EnumToStr, MFMAPI_PostAction_StrToEnum) ||
+        !IsKnown<MFMAPI_Thread>(a_record.thread, MFMAPI_Thread_EnumToStr, MFMAPI_Thread_StrToEnum)) {
+        return std::nullopt;
+    }
+
+    MFM_Function func;
+    func.dll = *dll;
+    func.api = *api;
+    func.type = static_cast<MFMAPI_Type>(a_record.type);
+    func.preAction = static_cast<MFMAPI_PreAction>(a_record.preAction);
+    func.postAction = static_cast<MFMAPI_PostAction>(a_record.postAction);
+    func.thread = static_cast<MFMAPI_Thread>(a_record.thread);
+    func.hotkey = *hotkey;
+    return func;
+}
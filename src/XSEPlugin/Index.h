@@ -0,0 +1,139 @@
+#pragma once
+
+#include <XSEPlugin/Core.h>
+#include <XSEPlugin/Util/Singleton.h>
+#include <XSEPlugin/Util/Win.h>
+
+/// A persistent index of directory listings and parsed functions, so that
+/// startup neither walks filesystem nor parses function files again.
+///
+/// Records are validated lazily: a directory record is used only if the last
+/// write time and entry count of that directory still match, and a function
+/// record only if the last write time and size of that file still match. On
+/// mismatch, caller falls back to a live scan of only that directory or file.
+///
+/// @note
+///   Thread-safe.
+class Index final : public Singleton<Index>
+{
+    friend class Singleton<Index>;
+
+public:
+    [[nodiscard]] std::optional<MFM_Listing> FindListing(const std::filesystem::path& a_path,
+        const MFM_Fingerprint& a_fingerprint) const;
+
+    void PutListing(const std::filesystem::path& a_path, const MFM_Listing& a_listing);
+
+    [[nodiscard]] std::optional<MFM_Function> FindFunction(const std::filesystem::path& a_path,
+        const MFM_FileStamp& a_stamp) const;
+
+    void PutFunction(const std::filesystem::path& a_path, const MFM_FileStamp& a_stamp, const MFM_Function& a_func);
+
+    /// Paths of functions bound to hotkeys, as of their records, which may
+    /// be stale, in order. Functions never parsed are not known.
+    [[nodiscard]] std::vector<std::string> FindHotkeyFunctions() const;
+
+    /// Write index file if any record was put since last save.
+    ///
+    /// Records are copied under lock, and written after it is released, so
+    /// that lookups wait only while the new file is swapped in.
+    void Save();
+
+private:
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t dirCount;
+        std::uint32_t entryCount;
+        std::uint32_t funcCount;
+        std::uint32_t stringSize;
+        std::uint32_t reserved[2];
+    };
+
+    struct DirRecord
+    {
+        MFM_StringRef key;
+        std::int64_t  mtime;
+        std::uint32_t count;
+        std::uint32_t firstEntry;
+        std::uint32_t entryCount;
+        std::uint32_t reserved;
+    };
+
+    struct EntryRecord
+    {
+        MFM_StringRef fileName;
+        std::uint32_t type;
+    };
+
+    struct FuncRecord
+    {
+        MFM_StringRef key;
+        std::int64_t  mtime;
+        std::uint64_t size;
+        MFM_StringRef dll;
+        MFM_StringRef api;
+        std::uint32_t type;
+        std::uint32_t preAction;
+        std::uint32_t postAction;
+        std::uint32_t thread;
+        MFM_StringRef hotkey;
+    };
+
+    struct FuncValue
+    {
+        MFM_FileStamp stamp;
+        MFM_Function  func;
+    };
+
+    /// The content of an index file, ready to write.
+    struct Image
+    {
+        Header                   header;
+        std::vector<DirRecord>   dirs;
+        std::vector<EntryRecord> entries;
+        std::vector<FuncRecord>  funcs;
+        std::string              strings;
+    };
+
+    static constexpr std::uint32_t magic = 0x494D464D;  // "MFMI"
+    static constexpr std::uint32_t version = 2;
+
+    Index();
+
+    ~Index() = default;
+
+    /// Map index file and validate its layout. Leave index empty on failure.
+    void Load();
+
+    /// Merge new records with those of index file. Called with lock held.
+    [[nodiscard]] Image Serialize() const;
+
+    static void Write(const std::filesystem::path& a_path, const Image& a_image);
+
+    [[nodiscard]] std::optional<std::string_view> String(MFM_StringRef a_ref) const noexcept;
+
+    [[nodiscard]] const DirRecord*  FindDir(std::string_view a_key) const noexcept;
+    [[nodiscard]] const FuncRecord* FindFunc(std::string_view a_key) const noexcept;
+
+    [[nodiscard]] std::optional<MFM_Listing>  ToListing(const DirRecord& a_record) const;
+    [[nodiscard]] std::optional<MFM_Function> ToFunction(const FuncRecord& a_record) const;
+
+    static inline const std::filesystem::path _path{ L"Data/SKSE/Plugins/ccld_ModFunctionMenu.index"sv };
+
+    mutable std::shared_mutex _mutex;
+    std::mutex                _saveMutex;  // Serialize saves only.
+
+    // Records of index file.
+    Win::MappedFile              _file;
+    std::span<const DirRecord>   _dirs;
+    std::span<const EntryRecord> _entries;
+    std::span<const FuncRecord>  _funcs;
+    std::string_view             _strings;
+
+    // Records put since last save, which take precedence over index file.
+    std::map<std::string, MFM_Listing, std::less<>> _newDirs;
+    std::map<std::string, FuncValue, std::less<>>   _newFuncs;
+    std::uint64_t                                   _putCount{ 0 };  // Records put, to detect puts during save.
+};
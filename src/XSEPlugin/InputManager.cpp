@@ -1,150 +1,291 @@
 #include "InputManager.h"
 
 #include <XSEPlugin/Base/Configuration.h>
+#include <XSEPlugin/Core.h>
 #include <XSEPlugin/ImGui/Input.h>
 #include <XSEPlugin/ImGui/Menu.h>
+#include <XSEPlugin/ImGui/Renderer.h>
+#include <XSEPlugin/InputRecorder.h>
+#include <XSEPlugin/Util/CLib/Hotkey.h>
 #include <XSEPlugin/Util/CLib/Key.h>
 
 namespace
 {
-    class MenuOpenHotkeyContext
+    /// Add a hotkey of single step, unless disabled.
+    inline void AddHotkey(CLib::HotkeySet& a_hotkeys, std::uint32_t a_key, std::uint32_t a_modifier)
     {
-    public:
-        void Load()
-        {
-            auto& cfgControls = Configuration::GetSingleton()->controls;
+        if (a_key == CLib::INVALID_KEY) {
+            return;
+        }
 
-            keyboard.Load(cfgControls.keyboard.iHotkey, cfgControls.keyboard.iModifier);
-            gamepad.Load(cfgControls.gamepad.iHotkey, cfgControls.gamepad.iModifier);
+        CLib::HotkeySet::Step step{ {}, a_key, CLib::HotkeySet::Mode::kPress };
+        if (a_modifier != CLib::INVALID_KEY) {
+            step.modifiers.push_back(a_modifier);
+        }
+        a_hotkeys.Add({ std::addressof(step), 1 });
+    }
+
+    /// Add the menu hotkey of device, preferring sHotkey to iHotkey and
+    /// iModifier.
+    template <class Device>
+    inline void AddHotkey(CLib::HotkeySet& a_hotkeys, const Device& a_device)
+    {
+        if (!a_device.sHotkey.empty()) {
+            if (auto steps = CLib::HotkeySet::Parse(a_device.sHotkey); steps && a_hotkeys.Add(*steps)) {
+                return;
+            }
+            SKSE::log::warn("Ignore invalid hotkey \"{}\".", a_device.sHotkey);
         }
+        AddHotkey(a_hotkeys, a_device.iHotkey, a_device.iModifier);
+    }
 
-        void Reset() noexcept
+    class MenuHotkeyContext
+    {
+    public:
+        void Reset() noexcept { hotkeys.Reset(); }
+
+        void Update(const InputRecord& a_record, std::uint32_t a_key)
         {
-            keyboard.Reset();
-            gamepad.Reset();
+            hotkeys.Update(a_key, a_record.IsPressed(), a_record.IsDown(), a_record.held);
         }
 
-        void Update(const RE::ButtonEvent* a_button)
+    protected:
+        void LoadMenuHotkeys(const Configuration& a_config)
         {
-            if (!a_button->HasIDCode()) {
-                return;
-            }
+            const auto& cfgControls = a_config.controls;
+
+            CLib::HotkeySet::Timing timing;
+            timing.doubleTap = std::chrono::milliseconds{ cfgControls.iDoubleTapTime };
+            timing.hold = std::chrono::milliseconds{ cfgControls.iHoldTime };
+            timing.sequence = std::chrono::milliseconds{ cfgControls.iSequenceTime };
+
+            hotkeys.Clear();
+            hotkeys.SetTiming(timing);
+            AddHotkey(hotkeys, cfgControls.keyboard);
+            AddHotkey(hotkeys, cfgControls.gamepad);
+        }
 
-            if (a_button->IsPressed()) {
-                auto key = CLib::ParseKey(a_button->GetIDCode(), a_button->GetDevice());
+        [[nodiscard]] bool IsTriggered() { return !hotkeys.Finalize(CLib::HotkeySet::Clock::now()).empty(); }
 
-                keyboard.UpdatePressed(key);
-                gamepad.UpdatePressed(key);
+        CLib::HotkeySet hotkeys;
+    };
+
+    /// Open the menu, or invoke functions bound to hotkeys in their files.
+    class MenuOpenHotkeyContext : public MenuHotkeyContext
+    {
+    public:
+        void Load(const Configuration& a_config, std::shared_ptr<const std::vector<MFM_HotkeyBinding>> a_functions)
+        {
+            LoadMenuHotkeys(a_config);
+            _menuHotkeyCount = hotkeys.Count();
 
-                if (a_button->IsDown()) {
-                    keyboard.UpdateDown(key);
-                    gamepad.UpdateDown(key);
+            _functions = std::move(a_functions);
+            _targets.clear();
+            if (!_functions) {
+                return;
+            }
+            for (std::size_t i = 0; i < _functions->size(); ++i) {
+                const auto& binding = (*_functions)[i];
+                auto        steps = CLib::HotkeySet::Parse(binding.func->hotkey);
+                if (!steps || !hotkeys.Add(*steps)) {
+                    SKSE::log::warn("Ignore invalid hotkey \"{}\" of \"{}\".", binding.func->hotkey, binding.path);
+                    continue;
                 }
+                _targets.push_back(i);
             }
+            SKSE::log::debug("InputManager: Bind {} functions to hotkeys.", _targets.size());
         }
 
-        void Finalize()
+        void Finalize(CLib::HotkeySet::Clock::time_point a_arrival)
         {
-            if (keyboard.IsActive() || gamepad.IsActive()) {
-                ImGui::Menu::GetSingleton()->Open();
+            auto menu = ImGui::Menu::GetSingleton();
+            for (auto index : hotkeys.Finalize(CLib::HotkeySet::Clock::now())) {
+                if (index < _menuHotkeyCount) {
+                    ImGui::Renderer::GetSingleton()->frameStats.MarkInput(a_arrival);
+                    menu->Open();
+                } else {
+                    menu->InvokeHotkey((*_functions)[_targets[index - _menuHotkeyCount]]);
+                }
             }
         }
 
     private:
-        CLib::KeyCombo keyboard;
-        CLib::KeyCombo gamepad;
+        std::size_t                                           _menuHotkeyCount{ 0 };
+        std::shared_ptr<const std::vector<MFM_HotkeyBinding>> _functions;
+        std::vector<std::size_t>                              _targets;  // Index of function, by binding after menu.
     };
 
-    class MenuCloseHotkeyContext
+    class MenuCloseHotkeyContext : public MenuHotkeyContext
     {
     public:
-        void Load()
+        void Load(const Configuration& a_config)
         {
-            auto& cfgControls = Configuration::GetSingleton()->controls;
+            const auto& cfgControls = a_config.controls;
 
-            keyboard.Load(cfgControls.keyboard.iHotkey, cfgControls.keyboard.iModifier);
-            gamepad.Load(cfgControls.gamepad.iHotkey, cfgControls.gamepad.iModifier);
-            kbExtraExit.Load(cfgControls.keyboard.iExtraExit);
-            gpExtraExit.Load(cfgControls.gamepad.iExtraExit);
+            LoadMenuHotkeys(a_config);
+            AddHotkey(hotkeys, cfgControls.keyboard.iExtraExit, CLib::INVALID_KEY);
+            AddHotkey(hotkeys, cfgControls.gamepad.iExtraExit, CLib::INVALID_KEY);
         }
 
-        void Reset() noexcept
+        void Finalize(CLib::HotkeySet::Clock::time_point)
         {
-            keyboard.Reset();
-            gamepad.Reset();
-            kbExtraExit.Reset();
-            gpExtraExit.Reset();
+            if (IsTriggered()) {
+                ImGui::Menu::GetSingleton()->Close();
+            }
         }
+    };
+
+    /// Stop replay by menu hotkey, as live input is ignored meanwhile.
+    class ReplayCancelHotkeyContext : public MenuHotkeyContext
+    {
+    public:
+        void Load(const Configuration& a_config) { LoadMenuHotkeys(a_config); }
 
-        void Update(const RE::ButtonEvent* a_button)
+        void Finalize(CLib::HotkeySet::Clock::time_point)
         {
-            if (!a_button->HasIDCode()) {
-                return;
+            if (IsTriggered()) {
+                InputRecorder::StopReplay();
             }
+        }
+    };
 
-            if (a_button->IsPressed()) {
-                auto key = CLib::ParseKey(a_button->GetIDCode(), a_button->GetDevice());
-
-                keyboard.UpdatePressed(key);
-                gamepad.UpdatePressed(key);
+    MenuOpenHotkeyContext     openCtx;
+    MenuCloseHotkeyContext    closeCtx;
+    ReplayCancelHotkeyContext cancelCtx;
 
-                if (a_button->IsDown()) {
-                    keyboard.UpdateDown(key);
-                    gamepad.UpdateDown(key);
-                    kbExtraExit.Update(key);
-                    gpExtraExit.Update(key);
-                }
+    template <class Func>
+    inline void ForEachRecord(const RE::InputEvent* const* a_event, Func&& a_func)
+    {
+        for (auto event = *a_event; event; event = event->next) {
+            if (auto record = InputRecord::From(event)) {
+                a_func(*record);
             }
         }
+    }
 
-        void Finalize()
-        {
-            if (kbExtraExit.IsActive() || keyboard.IsActive() || gpExtraExit.IsActive() || gamepad.IsActive()) {
-                ImGui::Menu::GetSingleton()->Close();
-            }
+    template <class Func>
+    inline void ForEachRecord(std::span<const InputRecord> a_batch, Func&& a_func)
+    {
+        for (const auto& record : a_batch) {
+            a_func(record);
         }
+    }
 
-    private:
-        CLib::KeyCombo keyboard;
-        CLib::KeyCombo gamepad;
-        CLib::Key      kbExtraExit;
-        CLib::Key      gpExtraExit;
-    };
+    [[nodiscard]] inline bool IsEmpty(const RE::InputEvent* const* a_event) noexcept { return !*a_event; }
 
-    MenuOpenHotkeyContext  openCtx;
-    MenuCloseHotkeyContext closeCtx;
+    [[nodiscard]] inline bool IsEmpty(std::span<const InputRecord> a_batch) noexcept { return a_batch.empty(); }
 
-    template <class HotkeyContext>
-    inline void ProcessHotkey(HotkeyContext* ctx, const RE::InputEvent* const* a_event)
+    /// Walk events once, feeding hotkey context and, if translate is set,
+    /// ImGui. Each button is parsed to keycode only once for both.
+    ///
+    /// @param a_arrival
+    ///   When events arrived at input hook, which is traced to the frame
+    ///   that draws their effect.
+    template <bool Translate, class HotkeyContext, class Events>
+    inline void Dispatch(HotkeyContext* ctx, const Events& a_events, CLib::HotkeySet::Clock::time_point a_arrival)
     {
         ctx->Reset();
-        for (auto event = *a_event; event; event = event->next) {
-            if (auto button = event->AsButtonEvent()) {
-                ctx->Update(button);
+        ForEachRecord(a_events, [ctx](const InputRecord& a_record) {
+            switch (a_record.type) {
+            case InputRecord::Type::kButton:
+                {
+                    auto key = CLib::ParseKey(a_record.code, static_cast<RE::INPUT_DEVICE>(a_record.device));
+                    if constexpr (Translate) {
+                        ImGui::TranslateButtonEvent(key, a_record.IsPressed(), a_record.value);
+                    }
+                    ctx->Update(a_record, key);
+                }
+                break;
+            case InputRecord::Type::kChar:
+                if constexpr (Translate) {
+                    ImGui::TranslateCharEvent(a_record.code);
+                }
+                break;
             }
+        });
+        if constexpr (Translate) {
+            if (!IsEmpty(a_events)) {
+                // Input still blocked after the menu closed draws nothing.
+                if (ImGui::Menu::GetSingleton()->IsOpen()) {
+                    ImGui::Renderer::GetSingleton()->frameStats.MarkInput(a_arrival);
+                }
+                ImGui::CommitInputEvent();
+            }
+        }
+        ctx->Finalize(a_arrival);
+    }
+
+    /// Dispatch events to the hotkey context of current blocking state.
+    template <class Events>
+    inline void DispatchBatch(const Events& a_events, CLib::HotkeySet::Clock::time_point a_arrival)
+    {
+        if (InputBlocker::IsNotBlocked()) {
+            Dispatch<false>(std::addressof(openCtx), a_events, a_arrival);
+        } else {
+            Dispatch<true>(std::addressof(closeCtx), a_events, a_arrival);
+        }
+    }
+}
+
+std::optional<InputRecord> InputRecord::From(const RE::InputEvent* a_event)
+{
+    if (auto button = a_event->AsButtonEvent()) {
+        if (!button->HasIDCode()) {
+            return std::nullopt;
+        }
+        std::uint32_t flags = 0;
+        if (button->IsPressed()) {
+            flags |= kPressed;
+        }
+        if (button->IsDown()) {
+            flags |= kDown;
         }
-        ctx->Finalize();
+        return InputRecord{ Type::kButton, static_cast<std::uint32_t>(button->GetDevice()), button->GetIDCode(),
+            button->Value(), button->HeldDuration(), flags };
     }
+    if (auto charEvent = a_event->AsCharEvent()) {
+        return InputRecord{ Type::kChar, static_cast<std::uint32_t>(charEvent->GetDevice()), charEvent->keycode, 0.0f,
+            0.0f, 0 };
+    }
+    return std::nullopt;
 }
 
 void InputManager::Process(const RE::InputEvent* const* a_event)
 {
-    if (Configuration::IsVersionChanged(_configVersion)) {
-        std::shared_lock configLock{ Configuration::Mutex() };
+    auto arrival = CLib::HotkeySet::Clock::now();
 
-        openCtx.Load();
-        closeCtx.Load();
+    if (InputRecorder::IsReplaying()) {
+        // Live input is ignored until replay ends, except menu hotkey.
+        Reload();
+        Dispatch<false>(std::addressof(cancelCtx), a_event, arrival);
+        InputRecorder::Replay();
+        return;
+    }
+    InputRecorder::Record(a_event);
 
+    Reload();
+    DispatchBatch(a_event, arrival);
+}
+
+void InputManager::Process(std::span<const InputRecord> a_batch)
+{
+    Reload();
+    DispatchBatch(a_batch, CLib::HotkeySet::Clock::now());
+}
+
+void InputManager::Reload()
+{
+    if (Configuration::IsVersionChanged(_configVersion) || Datastore::HotkeyVersion() != _hotkeyVersion) {
         _configVersion = Configuration::Version();
+        _hotkeyVersion = Datastore::HotkeyVersion();
 
-        SKSE::log::debug("InputManager: Upgrade to Configuration Version {}.", _configVersion);
-    }
+        auto config = Configuration::GetSingleton();
+        openCtx.Load(*config, Datastore::Hotkeys());
+        closeCtx.Load(*config);
+        cancelCtx.Load(*config);
 
-    if (InputBlocker::IsNotBlocked()) {
-        ProcessHotkey(std::addressof(openCtx), a_event);
-    } else {
-        ImGui::TranslateInputEvent(a_event);
-        ProcessHotkey(std::addressof(closeCtx), a_event);
+        SKSE::log::debug("InputManager: Upgrade to Configuration Version {}, Hotkey Version {}.", _configVersion,
+            _hotkeyVersion);
     }
 }
 
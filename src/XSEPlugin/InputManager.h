@@ -32,12 +32,50 @@ private:
     static inline std::atomic<BlockState> _state{ BlockState ::kNotBlocked };
 };
 
+/// An input event reduced to what input handling reads, so that input can be
+/// recorded and replayed without game objects.
+struct InputRecord
+{
+    enum class Type : std::uint32_t
+    {
+        kButton = 0,
+        kChar = 1,
+    };
+
+    enum Flag : std::uint32_t
+    {
+        kPressed = 1 << 0,
+        kDown = 1 << 1,
+    };
+
+    /// Reduce a game event. Return nothing if input handling ignores it.
+    [[nodiscard]] static std::optional<InputRecord> From(const RE::InputEvent* a_event);
+
+    [[nodiscard]] bool IsPressed() const noexcept { return (flags & kPressed) != 0; }
+    [[nodiscard]] bool IsDown() const noexcept { return (flags & kDown) != 0; }
+
+    Type          type;
+    std::uint32_t device;  // RE::INPUT_DEVICE of button.
+    std::uint32_t code;    // ID code of button, or character.
+    float         value;
+    float         held;  // Seconds held down.
+    std::uint32_t flags;
+};
+
 class InputManager
 {
 public:
     static void Process(const RE::InputEvent* const* a_event);
+
+    /// Process a batch of recorded events as if it came from game.
+    static void Process(std::span<const InputRecord> a_batch);
+
     static void Cleanup();
 
 private:
+    /// Reload hotkeys if configuration or functions bound to hotkeys changed.
+    static void Reload();
+
     static inline std::uint32_t _configVersion{ 0 };
+    static inline std::uint32_t _hotkeyVersion{ 0 };
 };
@@ -0,0 +1,284 @@
+#include "InputRecorder.h"
+
+#include <XSEPlugin/ImGui/Menu.h>
+#include <XSEPlugin/Util/Binary.h>
+#include <XSEPlugin/Util/Win.h>
+
+namespace
+{
+    constexpr auto kLogFileName = "ccld_ModFunctionMenu_Input.bin"sv;
+    constexpr auto kReportFileName = "ccld_ModFunctionMenu_Replay.txt"sv;
+}
+
+void InputRecorder::StartRecording()
+{
+    std::scoped_lock lock{ _mutex };
+    _batches.clear();
+    _records.clear();
+    _menuOpen = ImGui::Menu::GetSingleton()->IsOpen();
+    _start = Clock::now();
+    _recording.store(true);
+
+    SKSE::log::info("Start recording input.");
+}
+
+std::string InputRecorder::StopRecording()
+{
+    std::scoped_lock lock{ _mutex };
+    _recording.store(false);
+
+    auto batches = std::exchange(_batches, {});
+    auto records = std::exchange(_records, {});
+
+    auto path = Path(kLogFileName);
+    if (!path) {
+        return "Failed to find SKSE logging directory."s;
+    }
+
+    Header header{};
+    header.magic = magic;
+    header.version = version;
+    header.batchCount = static_cast<std::uint32_t>(batches.size());
+    header.recordCount = static_cast<std::uint32_t>(records.size());
+    header.menuOpen = _menuOpen ? 1 : 0;
+
+    try {
+        std::ofstream file{ *path, std::ios::binary | std::ios::trunc };
+        file.exceptions(std::ios::failbit | std::ios::badbit);
+
+        std::size_t offset = 0;
+        Binary::Put(file, offset, std::span<const Header>{ &header, 1 });
+        Binary::Put(file, offset, std::span<const BatchRecord>{ batches });
+        Binary::Put(file, offset, std::span<const InputRecord>{ records });
+    } catch (const std::system_error& e) {
+        return std::format("Failed to save input to \"{}\": {}.", PathToStr(*path),
+            SKSE::stl::ansi_to_utf8(e.what()).value_or(e.what()));
+    }
+
+    SKSE::log::info("Stop recording input: {} batches of {} events.", batches.size(), records.size());
+    return std::format("Recorded {} batches of {} events to \"{}\".", batches.size(), records.size(),
+        PathToStr(*path));
+}
+
+std::string InputRecorder::StartReplay()
+{
+    if (IsRecording()) {
+        return "Stop recording input first."s;
+    }
+
+    auto path = Path(kLogFileName);
+    if (!path) {
+        return "Failed to find SKSE logging directory."s;
+    }
+
+    Win::MappedFile file;
+    if (!file.Open(path->c_str())) {
+        return std::format("No input recorded at \"{}\".", PathToStr(*path));
+    }
+
+    auto data = file.data();
+
+    std::size_t offset = 0;
+    auto        header = Binary::Take<Header>(data, offset, 1);
+    if (!header || header->front().magic != magic || header->front().version != version) {
+        return std::format("Ignore \"{}\": unknown format.", PathToStr(*path));
+    }
+
+    const auto& h = header->front();
+    auto        batches = Binary::Take<BatchRecord>(data, offset, h.batchCount);
+    auto        records = Binary::Take<InputRecord>(data, offset, h.recordCount);
+    if (!batches || !records) {
+        return std::format("Ignore \"{}\": truncated.", PathToStr(*path));
+    }
+    for (const auto& batch : *batches) {
+        if (batch.firstRecord > h.recordCount || batch.recordCount > h.recordCount - batch.firstRecord) {
+            return std::format("Ignore \"{}\": bad batch.", PathToStr(*path));
+        }
+    }
+    for (const auto& record : *records) {
+        if (record.type != InputRecord::Type::kButton && record.type != InputRecord::Type::kChar) {
+            return std::format("Ignore \"{}\": bad event.", PathToStr(*path));
+        }
+    }
+    if (batches->empty()) {
+        return "Nothing recorded."s;
+    }
+
+    {
+        std::scoped_lock lock{ _mutex };
+        if (IsReplaying()) {
+            return "Input is being replayed."s;
+        }
+        _batches.assign(batches->begin(), batches->end());
+        _records.assign(records->begin(), records->end());
+        _menuOpen = h.menuOpen != 0;
+        _next = 0;
+        _samples.clear();
+        _samples.reserve(_batches.size());
+        _start = Clock::now();
+        ++_session;
+        _replaying.store(true);
+    }
+
+    // Start from the state of recording.
+    auto menu = ImGui::Menu::GetSingleton();
+    if (h.menuOpen != 0) {
+        menu->Open();
+    } else {
+        menu->Close();
+    }
+
+    SKSE::log::info("Start replaying input: {} batches of {} events.", h.batchCount, h.recordCount);
+    return std::format("Replaying {} batches of {} events. Live input is ignored until it ends, then a report is "
+                       "written to \"{}\" in SKSE logging directory. Press menu hotkey to stop.",
+        h.batchCount, h.recordCount, kReportFileName);
+}
+
+std::string InputRecorder::StopReplay()
+{
+    std::scoped_lock lock{ _mutex };
+    if (!IsReplaying()) {
+        return "Input is not being replayed."s;
+    }
+
+    auto replayed = _samples.size();
+    auto total = _batches.size();
+    Report();
+
+    SKSE::log::info("Stop replaying input after {} of {} batches.", replayed, total);
+    return std::format("Stopped replaying input after {} of {} batches.", replayed, total);
+}
+
+void InputRecorder::Record(const RE::InputEvent* const* a_event)
+{
+    if (!IsRecording()) {
+        return;
+    }
+
+    auto now = Clock::now();
+
+    std::scoped_lock lock{ _mutex };
+    if (!IsRecording()) {
+        return;
+    }
+
+    auto first = static_cast<std::uint32_t>(_records.size());
+    for (auto event = *a_event; event; event = event->next) {
+        if (auto record = InputRecord::From(event)) {
+            _records.push_back(*record);
+        }
+    }
+    // Idle batches are implied by time.
+    if (_records.size() == first) {
+        return;
+    }
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _start).count();
+    _batches.push_back({ time, first, static_cast<std::uint32_t>(_records.size()) - first });
+}
+
+void InputRecorder::Replay()
+{
+    std::vector<InputRecord> batch;
+    std::uint32_t            session = 0;
+    std::size_t              next = 0;
+    bool                     due = false;
+    {
+        std::scoped_lock lock{ _mutex };
+        if (!IsReplaying()) {
+            return;
+        }
+
+        session = _session;
+        next = _next;
+        due = next < _batches.size() && Clock::now() - _start >= std::chrono::nanoseconds{ _batches[next].time };
+        if (due) {
+            const auto& record = _batches[next];
+            auto        first = _records.begin() + record.firstRecord;
+            batch.assign(first, first + record.recordCount);
+        }
+    }
+
+    auto menu = ImGui::Menu::GetSingleton();
+    auto wasOpen = menu->IsOpen();
+    auto start = Clock::now();
+    InputManager::Process(batch);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    if (!due) {
+        return;
+    }
+
+    std::scoped_lock lock{ _mutex };
+    // Replay may have been stopped meanwhile.
+    if (!IsReplaying() || _session != session) {
+        return;
+    }
+    _samples.push_back({ static_cast<std::uint32_t>(next),
+        static_cast<std::uint32_t>(std::min<std::int64_t>(elapsed, UINT32_MAX)), wasOpen, menu->IsOpen() });
+    if (++_next == _batches.size()) {
+        Report();
+    }
+}
+
+std::optional<std::filesystem::path> InputRecorder::Path(std::string_view a_fileName)
+{
+    auto path = SKSE::log::log_directory();
+    if (path) {
+        *path /= a_fileName;
+    }
+    return path;
+}
+
+void InputRecorder::Report()
+{
+    ++_session;
+    if (_samples.empty()) {
+        _batches.clear();
+        _records.clear();
+        _replaying.store(false);
+        return;
+    }
+
+    std::vector<std::uint32_t> elapsed;
+    elapsed.reserve(_samples.size());
+    for (const auto& sample : _samples) {
+        elapsed.push_back(sample.elapsed);
+    }
+    std::ranges::sort(elapsed);
+    auto percentile = [&elapsed](std::size_t a_percent) { return elapsed[(elapsed.size() - 1) * a_percent / 100]; };
+    auto p50 = percentile(50);
+    auto p99 = percentile(99);
+    auto max = elapsed.back();
+
+    std::string report;
+    auto        out = std::back_inserter(report);
+
+    std::format_to(out, "Replayed {} batches of {} events.\n\n", _samples.size(), _records.size());
+    std::format_to(out, "Processing time, in microseconds: p50 = {}, p99 = {}, max = {}.\n\n", p50, p99, max);
+    std::format_to(out, "{:>8}{:>12}{:>8}{:>14}  {}\n", "Batch", "Time (ms)", "Events", "Elapsed (us)", "Menu");
+    for (const auto& sample : _samples) {
+        const auto& batch = _batches[sample.batch];
+        auto        transition = sample.wasOpen == sample.isOpen ? ""sv : sample.isOpen ? "Open"sv : "Close"sv;
+        std::format_to(out, "{:>8}{:>12.3f}{:>8}{:>14}  {}\n", sample.batch, static_cast<double>(batch.time) / 1e6,
+            batch.recordCount, sample.elapsed, transition);
+    }
+
+    SKSE::log::info("Stop replaying input: {} batches, processing time p50 = {} us, p99 = {} us, max = {} us.",
+        _samples.size(), p50, p99, max);
+
+    if (auto path = Path(kReportFileName)) {
+        try {
+            std::ofstream file{ *path, std::ios::binary | std::ios::trunc };
+            file.exceptions(std::ios::failbit | std::ios::badbit);
+            file << report;
+        } catch (const std::system_error& e) {
+            SKSE::log::warn("Failed to save replay report to \"{}\": {}.", PathToStr(*path),
+                SKSE::stl::ansi_to_utf8(e.what()).value_or(e.what()));
+        }
+    }
+
+    _batches.clear();
+    _records.clear();
+    _samples.clear();
+    _replaying.store(false);
+}
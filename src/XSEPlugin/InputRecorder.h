@@ -0,0 +1,102 @@
+#pragma once
+
+#include <XSEPlugin/InputManager.h>
+
+/// Records batches of input events into a binary log, and replays them in
+/// place of live input, so that input handling can be reproduced and timed.
+///
+/// A recorded batch is replayed no earlier than it was recorded, and at most
+/// one per live batch, so that menu and renderer run through frames as they
+/// did while recording. Live input is ignored until replay ends, except the
+/// menu hotkey, which stops it.
+///
+/// @note
+///   Thread-safe.
+class InputRecorder
+{
+public:
+    [[nodiscard]] static bool IsRecording() noexcept { return _recording.load(); }
+
+    [[nodiscard]] static bool IsReplaying() noexcept { return _replaying.load(); }
+
+    /// Start recording, discarding previous recording if any.
+    static void StartRecording();
+
+    /// Stop recording and save log.
+    ///
+    /// @return
+    ///   Message to show.
+    static std::string StopRecording();
+
+    /// Load log and replay it from next live batch.
+    ///
+    /// @return
+    ///   Message to show.
+    static std::string StartReplay();
+
+    /// Stop replay, and report the batches replayed so far.
+    ///
+    /// @return
+    ///   Message to show.
+    static std::string StopReplay();
+
+    /// Record a batch of live events, if recording.
+    static void Record(const RE::InputEvent* const* a_event);
+
+    /// Process the next recorded batch if it is due, or an empty batch
+    /// otherwise. Report after the last one, and end replay.
+    ///
+    /// The batch is processed without lock, since it may invoke functions
+    /// that call back into recorder.
+    static void Replay();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t batchCount;
+        std::uint32_t recordCount;
+        std::uint32_t menuOpen;  // Whether the menu was open at start.
+        std::uint32_t reserved[3];
+    };
+
+    struct BatchRecord
+    {
+        std::int64_t  time;  // Nanoseconds since start.
+        std::uint32_t firstRecord;
+        std::uint32_t recordCount;
+    };
+
+    /// A replayed batch.
+    struct Sample
+    {
+        std::uint32_t batch;
+        std::uint32_t elapsed;  // Microseconds to process.
+        bool          wasOpen;
+        bool          isOpen;
+    };
+
+    static constexpr std::uint32_t magic = 0x524D464D;  // "MFMR"
+    static constexpr std::uint32_t version = 1;
+
+    [[nodiscard]] static std::optional<std::filesystem::path> Path(std::string_view a_fileName);
+
+    /// Write per-batch timings and menu transitions of replay, if any, and
+    /// clear it. Called with lock held.
+    static void Report();
+
+    static inline std::atomic<bool> _recording{ false };
+    static inline std::atomic<bool> _replaying{ false };
+
+    static inline std::mutex               _mutex;
+    static inline Clock::time_point        _start;
+    static inline bool                     _menuOpen{ false };
+    static inline std::vector<BatchRecord> _batches;
+    static inline std::vector<InputRecord> _records;
+    static inline std::size_t              _next{ 0 };  // Batch to replay.
+    static inline std::vector<Sample>      _samples;
+    static inline std::uint32_t            _session{ 0 };  // Increase whenever replay starts or stops.
+};
@@ -61,17 +61,9 @@ SKSEPluginLoad(const SKSE::LoadInterface* a_skse)
     SKSE::log::info("{} {} is loading...", plugin->GetName(), plugin->GetVersion().string("."sv));
 
     SKSE::Init(a_skse);
-    {
-        std::scoped_lock lock{ Configuration::Mutex(), Translation::Mutex() };
-
-        Configuration::Init();
-        Translation::Init();
-
-        ReconfigureLogger(Configuration::GetSingleton()->general.sLogLevel);
-
-        Configuration::IncrementVersion();
-        Translation::IncrementVersion();
-    }
+    Configuration::Init();
+    Translation::Init();
+    ReconfigureLogger(Configuration::GetSingleton()->general.sLogLevel);
     ImGui::Renderer::Install();
 
     SKSE::GetMessagingInterface()->RegisterListener(OnMessage);
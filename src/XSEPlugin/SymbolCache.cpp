@@ -0,0 +1,45 @@
+#include "SymbolCache.h"
+
+#include <XSEPlugin/Util/Win.h>
+
+void* MFM_Win32SymbolLoader::Resolve(const std::string& a_dll, const std::string& a_api)
+{
+    auto dllPath = StrToPath(a_dll);
+    return Win::GetModuleFunc<void (*)()>(dllPath.c_str(), a_api.c_str());
+}
+
+void* SymbolCache::Resolve(const std::string& a_dll, const std::string& a_api)
+{
+    auto key = std::make_pair(a_dll, a_api);
+    {
+        std::shared_lock lock{ _mutex };
+        if (auto it = _symbols.find(key); it != _symbols.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock{ _mutex };
+    if (auto it = _symbols.find(key); it != _symbols.end()) {
+        return it->second;
+    }
+
+    auto symbol = _loader->Resolve(a_dll, a_api);
+    if (!symbol) {
+        SKSE::log::warn("Unavailable function: dll = \"{}\", api = \"{}\".", a_dll, a_api);
+    }
+    _symbols.emplace(std::move(key), symbol);
+    return symbol;
+}
+
+void SymbolCache::ForgetMissing()
+{
+    std::unique_lock lock{ _mutex };
+    std::erase_if(_symbols, [](const auto& a_pair) { return a_pair.second == nullptr; });
+}
+
+void SymbolCache::SetLoader(std::unique_ptr<MFM_SymbolLoader> a_loader)
+{
+    std::unique_lock lock{ _mutex };
+    _loader = std::move(a_loader);
+    _symbols.clear();
+}
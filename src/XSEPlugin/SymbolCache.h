@@ -0,0 +1,52 @@
+#pragma once
+
+#include <XSEPlugin/Util/Singleton.h>
+
+/// Resolve exported functions of loaded modules.
+class MFM_SymbolLoader
+{
+public:
+    virtual ~MFM_SymbolLoader() = default;
+
+    /// Return nullptr if module is not loaded or does not export the function.
+    [[nodiscard]] virtual void* Resolve(const std::string& a_dll, const std::string& a_api) = 0;
+};
+
+/// Resolve by GetModuleHandleW and GetProcAddress.
+class MFM_Win32SymbolLoader final : public MFM_SymbolLoader
+{
+public:
+    [[nodiscard]] void* Resolve(const std::string& a_dll, const std::string& a_api) override;
+};
+
+/// Resolved symbols keyed by (dll, api), so that invoking a mod function does
+/// not convert path and look up module again.
+///
+/// Missing symbols are cached too, until ForgetMissing() is called, so that
+/// unavailable entries can be flagged cheaply.
+///
+/// @note
+///   Thread-safe.
+class SymbolCache final : public Singleton<SymbolCache>
+{
+    friend class Singleton<SymbolCache>;
+
+public:
+    /// Return nullptr if symbol is missing.
+    [[nodiscard]] void* Resolve(const std::string& a_dll, const std::string& a_api);
+
+    /// Forget missing symbols, in case their modules are loaded later.
+    void ForgetMissing();
+
+    /// Replace loader and clear cache.
+    void SetLoader(std::unique_ptr<MFM_SymbolLoader> a_loader);
+
+private:
+    SymbolCache() : _loader(std::make_unique<MFM_Win32SymbolLoader>()) {}
+
+    ~SymbolCache() = default;
+
+    std::shared_mutex                                    _mutex;
+    std::unique_ptr<MFM_SymbolLoader>                    _loader;
+    std::map<std::pair<std::string, std::string>, void*> _symbols;
+};
@@ -0,0 +1,94 @@
+#include "AllocStats.h"
+
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace AllocStats
+{
+    namespace
+    {
+        thread_local Counter counter{ 0, 0 };
+
+        [[nodiscard]] void* Allocate(std::size_t a_size) noexcept
+        {
+            Record(a_size);
+            return std::malloc(a_size != 0 ? a_size : 1);
+        }
+
+        [[nodiscard]] void* AllocateAligned(std::size_t a_size, std::align_val_t a_align) noexcept
+        {
+            Record(a_size);
+            return _aligned_malloc(a_size != 0 ? a_size : 1, static_cast<std::size_t>(a_align));
+        }
+    }
+
+    Counter Current() noexcept { return counter; }
+
+    void Record(std::size_t a_size) noexcept
+    {
+        ++counter.count;
+        counter.bytes += a_size;
+    }
+}
+
+// Replace global allocation functions of this module, so that allocations of
+// standard library are counted too.
+
+void* operator new(std::size_t a_size)
+{
+    if (auto ptr = AllocStats::Allocate(a_size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t a_size) { return ::operator new(a_size); }
+
+void* operator new(std::size_t a_size, const std::nothrow_t&) noexcept { return AllocStats::Allocate(a_size); }
+
+void* operator new[](std::size_t a_size, const std::nothrow_t&) noexcept { return AllocStats::Allocate(a_size); }
+
+void* operator new(std::size_t a_size, std::align_val_t a_align)
+{
+    if (auto ptr = AllocStats::AllocateAligned(a_size, a_align)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t a_size, std::align_val_t a_align) { return ::operator new(a_size, a_align); }
+
+void* operator new(std::size_t a_size, std::align_val_t a_align, const std::nothrow_t&) noexcept
+{
+    return AllocStats::AllocateAligned(a_size, a_align);
+}
+
+void* operator new[](std::size_t a_size, std::align_val_t a_align, const std::nothrow_t&) noexcept
+{
+    return AllocStats::AllocateAligned(a_size, a_align);
+}
+
+void operator delete(void* a_ptr) noexcept { std::free(a_ptr); }
+
+void operator delete[](void* a_ptr) noexcept { std::free(a_ptr); }
+
+void operator delete(void* a_ptr, std::size_t) noexcept { std::free(a_ptr); }
+
+void operator delete[](void* a_ptr, std::size_t) noexcept { std::free(a_ptr); }
+
+void operator delete(void* a_ptr, const std::nothrow_t&) noexcept { std::free(a_ptr); }
+
+void operator delete[](void* a_ptr, const std::nothrow_t&) noexcept { std::free(a_ptr); }
+
+void operator delete(void* a_ptr, std::align_val_t) noexcept { _aligned_free(a_ptr); }
+
+void operator delete[](void* a_ptr, std::align_val_t) noexcept { _aligned_free(a_ptr); }
+
+void operator delete(void* a_ptr, std::size_t, std::align_val_t) noexcept { _aligned_free(a_ptr); }
+
+void operator delete[](void* a_ptr, std::size_t, std::align_val_t) noexcept { _aligned_free(a_ptr); }
+
+void operator delete(void* a_ptr, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(a_ptr); }
+
+void operator delete[](void* a_ptr, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(a_ptr); }
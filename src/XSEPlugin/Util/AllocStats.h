@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Heap allocations made by each thread, counted by the global allocation
+/// functions of this module and by allocators installed into libraries.
+///
+/// Counters are thread-local, so that the render thread sees only its own
+/// allocations, and counting costs no synchronization.
+namespace AllocStats
+{
+    struct Counter
+    {
+        std::uint64_t count;
+        std::uint64_t bytes;
+
+        [[nodiscard]] Counter operator-(const Counter& a_rhs) const noexcept
+        {
+            return { count - a_rhs.count, bytes - a_rhs.bytes };
+        }
+    };
+
+    /// Allocations made by the calling thread so far.
+    [[nodiscard]] Counter Current() noexcept;
+
+    /// Count an allocation of the calling thread.
+    void Record(std::size_t a_size) noexcept;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+
+/// Helpers for binary files made of aligned arrays of trivial records.
+namespace Binary
+{
+    /// Take an array of records from mapped data, aligning offset first.
+    /// Return nothing if data is too short.
+    template <class T>
+    [[nodiscard]] std::optional<std::span<const T>> Take(std::span<const std::byte> a_data, std::size_t& a_offset,
+        std::uint32_t a_count) noexcept
+    {
+        auto offset = (a_offset + alignof(T) - 1) / alignof(T) * alignof(T);
+        if (offset > a_data.size() || a_count > (a_data.size() - offset) / sizeof(T)) {
+            return std::nullopt;
+        }
+        a_offset = offset + a_count * sizeof(T);
+        return std::span{ reinterpret_cast<const T*>(a_data.data() + offset), a_count };
+    }
+
+    /// Write an array of records, padding offset to their alignment first.
+    template <class T>
+    void Put(std::ofstream& a_file, std::size_t& a_offset, std::span<const T> a_records)
+    {
+        static constexpr char padding[alignof(T)]{};
+
+        auto offset = (a_offset + alignof(T) - 1) / alignof(T) * alignof(T);
+        a_file.write(padding, static_cast<std::streamsize>(offset - a_offset));
+        a_file.write(reinterpret_cast<const char*>(a_records.data()),
+            static_cast<std::streamsize>(a_records.size_bytes()));
+        a_offset = offset + a_records.size_bytes();
+    }
+}
@@ -0,0 +1,216 @@
+#include "Hotkey.h"
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_split.h>
+#include <absl/strings/strip.h>
+
+namespace CLib
+{
+    std::optional<std::vector<HotkeySet::Step>> HotkeySet::Parse(std::string_view a_str)
+    {
+        std::vector<Step> steps;
+        for (std::string_view part : absl::StrSplit(a_str, ',')) {
+            part = absl::StripAsciiWhitespace(part);
+
+            Step step{ {}, 0, Mode::kPress };
+            if (absl::ConsumeSuffix(&part, ":double"sv)) {
+                step.mode = Mode::kDoubleTap;
+            } else if (absl::ConsumeSuffix(&part, ":hold"sv)) {
+                step.mode = Mode::kHold;
+            }
+
+            std::vector<std::uint32_t> keys;
+            for (std::string_view token : absl::StrSplit(part, '+')) {
+                std::uint32_t key = 0;
+                if (!absl::SimpleAtoi(token, &key) || key == 0) {
+                    return std::nullopt;
+                }
+                keys.push_back(key);
+            }
+
+            step.key = keys.back();
+            keys.pop_back();
+            step.modifiers = std::move(keys);
+            steps.push_back(std::move(step));
+        }
+        return steps;
+    }
+
+    void HotkeySet::Clear()
+    {
+        _steps.clear();
+        _modifiers.clear();
+        _bindings.clear();
+        _dirty = true;
+    }
+
+    std::optional<std::size_t> HotkeySet::Add(std::span<const Step> a_steps)
+    {
+        auto inRange = [](std::uint32_t a_key) { return a_key > 0 && a_key < keyCount; };
+        if (a_steps.empty()) {
+            return std::nullopt;
+        }
+        for (const auto& step : a_steps) {
+            if (!inRange(step.key) || !std::ranges::all_of(step.modifiers, inRange)) {
+                return std::nullopt;
+            }
+        }
+
+        Binding binding{};
+        binding.stepBegin = static_cast<std::uint32_t>(_steps.size());
+        for (const auto& step : a_steps) {
+            auto modBegin = static_cast<std::uint32_t>(_modifiers.size());
+            _modifiers.insert(_modifiers.end(), step.modifiers.begin(), step.modifiers.end());
+            _steps.push_back({ step.key, step.mode, modBegin, static_cast<std::uint32_t>(_modifiers.size()) });
+        }
+        binding.stepEnd = static_cast<std::uint32_t>(_steps.size());
+        _bindings.push_back(binding);
+        _dirty = true;
+        return _bindings.size() - 1;
+    }
+
+    void HotkeySet::Reset() noexcept
+    {
+        _pressed.reset();
+        _events.clear();
+        _fired.clear();
+    }
+
+    void HotkeySet::Update(std::uint32_t a_key, bool a_pressed, bool a_down, float a_held)
+    {
+        if (!a_pressed || a_key >= keyCount) {
+            return;
+        }
+        // Held buttons are sent again every frame, so pressed state is
+        // rebuilt from each batch and never gets stuck.
+        _pressed.set(a_key);
+        _events.push_back({ a_key, a_down, a_held });
+    }
+
+    std::span<const std::size_t> HotkeySet::Finalize(Clock::time_point a_now)
+    {
+        if (_dirty) {
+            Build();
+        }
+
+        // Evaluate once all modifiers of batch are known, regardless of the
+        // order of events.
+        for (const auto& event : _events) {
+            ++_eventCount;
+
+            // Of bindings completed by the same event, fire only the most
+            // specific one, so that "F1" does not fire along with "Shift+F1".
+            std::optional<std::uint32_t> best;
+            std::uint32_t                bestModifiers = 0;
+
+            for (auto i = _watchOffsets[event.key]; i < _watchOffsets[event.key + 1]; ++i) {
+                const auto& watch = _watches[i];
+                auto&       binding = _bindings[watch.binding];
+                if (binding.lastEvent == _eventCount) {
+                    continue;
+                }
+                if (binding.step > 0 && a_now > binding.deadline) {
+                    binding.step = 0;
+                }
+                if (watch.step != binding.step && watch.step != 0) {
+                    continue;
+                }
+                if (!Match(binding, watch.step, event, a_now)) {
+                    continue;
+                }
+
+                binding.lastEvent = _eventCount;
+                if (binding.stepBegin + watch.step + 1 == binding.stepEnd) {
+                    binding.step = 0;
+                    const auto& step = _steps[binding.stepBegin + watch.step];
+                    if (auto modifiers = step.modEnd - step.modBegin; !best || modifiers > bestModifiers) {
+                        best = watch.binding;
+                        bestModifiers = modifiers;
+                    }
+                } else {
+                    binding.step = watch.step + 1;
+                    binding.deadline = a_now + _timing.sequence;
+                }
+            }
+
+            if (best) {
+                _fired.push_back(*best);
+            }
+        }
+        return _fired;
+    }
+
+    void HotkeySet::Build()
+    {
+        std::vector<std::uint32_t> counts(keyCount, 0);
+        for (const auto& step : _steps) {
+            ++counts[step.key];
+        }
+
+        _watchOffsets.assign(keyCount + 1, 0);
+        for (std::size_t key = 0; key < keyCount; ++key) {
+            _watchOffsets[key + 1] = _watchOffsets[key] + counts[key];
+        }
+
+        _watches.resize(_steps.size());
+        auto next = std::vector<std::uint32_t>(_watchOffsets.begin(), _watchOffsets.end() - 1);
+        for (std::uint32_t b = 0; b < _bindings.size(); ++b) {
+            const auto& binding = _bindings[b];
+            for (auto s = binding.stepBegin; s < binding.stepEnd; ++s) {
+                _watches[next[_steps[s].key]++] = { b, s - binding.stepBegin };
+            }
+        }
+        for (std::size_t key = 0; key < keyCount; ++key) {
+            std::ranges::stable_sort(_watches.begin() + _watchOffsets[key], _watches.begin() + _watchOffsets[key + 1],
+                std::ranges::greater{}, &Watch::step);
+        }
+
+        _dirty = false;
+    }
+
+    bool HotkeySet::IsModified(const CompiledStep& a_step) const noexcept
+    {
+        for (auto i = a_step.modBegin; i < a_step.modEnd; ++i) {
+            if (!_pressed.test(_modifiers[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool HotkeySet::Match(Binding& a_binding, std::uint32_t a_step, const Event& a_event, Clock::time_point a_now)
+    {
+        const auto& step = _steps[a_binding.stepBegin + a_step];
+        switch (step.mode) {
+        case Mode::kPress:
+            return a_event.down && IsModified(step);
+        case Mode::kDoubleTap:
+            if (!a_event.down || !IsModified(step)) {
+                return false;
+            }
+            if (a_binding.tapArmed && a_binding.tapStep == a_step && a_now - a_binding.lastTap <= _timing.doubleTap) {
+                a_binding.tapArmed = false;
+                return true;
+            }
+            a_binding.tapArmed = true;
+            a_binding.tapStep = a_step;
+            a_binding.lastTap = a_now;
+            return false;
+        case Mode::kHold:
+            if (a_event.down) {
+                a_binding.latched = false;
+            }
+            if (a_binding.latched || !IsModified(step)) {
+                return false;
+            }
+            if (std::chrono::duration<float>{ a_event.held } < _timing.hold) {
+                return false;
+            }
+            a_binding.latched = true;
+            return true;
+        default:
+            return false;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+namespace CLib
+{
+    /// A set of hotkey bindings evaluated against batches of button events.
+    ///
+    /// A binding is an ordered sequence of steps. Each step is a trigger key
+    /// along with any number of modifiers held down, and is matched when the
+    /// trigger is pressed, double-tapped or held. Keys are keycodes of
+    /// CLib::ParseKey.
+    ///
+    /// Bindings are compiled into a table of watchers indexed by trigger
+    /// key, so each event visits only the steps it may advance, and the cost
+    /// of a batch does not grow with the number of bindings.
+    class HotkeySet
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Mode : std::uint8_t
+        {
+            kPress,
+            kDoubleTap,
+            kHold,
+        };
+
+        struct Step
+        {
+            std::vector<std::uint32_t> modifiers;
+            std::uint32_t              key;
+            Mode                       mode;
+        };
+
+        struct Timing
+        {
+            Clock::duration doubleTap{ std::chrono::milliseconds{ 300 } };  // Max interval between taps.
+            Clock::duration hold{ std::chrono::milliseconds{ 500 } };       // Min time to hold.
+            Clock::duration sequence{ std::chrono::milliseconds{ 1000 } };  // Max interval between steps.
+        };
+
+        /// Parse binding of form "42+59, 4", where steps are separated by
+        /// comma and keys of a step by plus, the last one being the trigger.
+        /// A step may end with ":double" or ":hold".
+        ///
+        /// @return
+        ///   Nothing if malformed.
+        [[nodiscard]] static std::optional<std::vector<Step>> Parse(std::string_view a_str);
+
+        /// Remove all bindings.
+        void Clear();
+
+        /// Add a binding.
+        ///
+        /// @return
+        ///   The index of binding, or nothing if it is empty or any key is
+        ///   out of range.
+        std::optional<std::size_t> Add(std::span<const Step> a_steps);
+
+        /// The number of bindings, which are indexed in order of addition.
+        [[nodiscard]] std::size_t Count() const noexcept { return _bindings.size(); }
+
+        void SetTiming(const Timing& a_timing) noexcept { _timing = a_timing; }
+
+        /// Start a new batch of events.
+        void Reset() noexcept;
+
+        /// Record a button event of current batch.
+        ///
+        /// @param a_held
+        ///   Seconds the button has been held down.
+        void Update(std::uint32_t a_key, bool a_pressed, bool a_down, float a_held);
+
+        /// Evaluate current batch.
+        ///
+        /// A trigger event fires at most one binding: of those it completes,
+        /// the one whose last step has the most modifiers, or the earliest
+        /// added on a tie.
+        ///
+        /// @return
+        ///   Indices of bindings completed by this batch.
+        std::span<const std::size_t> Finalize(Clock::time_point a_now);
+
+        [[nodiscard]] bool IsPressed(std::uint32_t a_key) const noexcept
+        {
+            return a_key < keyCount && _pressed.test(a_key);
+        }
+
+    private:
+        static constexpr std::size_t keyCount = SKSE::InputMap::kMaxMacros;
+
+        struct CompiledStep
+        {
+            std::uint32_t key;
+            Mode          mode;
+            std::uint32_t modBegin;  // Range of modifiers.
+            std::uint32_t modEnd;
+        };
+
+        /// Run-time state of a binding.
+        struct Binding
+        {
+            std::uint32_t     stepBegin;  // Range of steps.
+            std::uint32_t     stepEnd;
+            std::uint32_t     step{ 0 };  // Next step to match.
+            Clock::time_point deadline;   // Of next step, if not the first.
+            std::uint32_t     tapStep{ 0 };
+            Clock::time_point lastTap;
+            bool              tapArmed{ false };
+            bool              latched{ true };  // Hold fired, or pressed before seen, until pressed again.
+            std::uint64_t     lastEvent{ 0 };   // Advanced at most once per event.
+        };
+
+        struct Watch
+        {
+            std::uint32_t binding;
+            std::uint32_t step;  // Relative to binding.
+        };
+
+        struct Event
+        {
+            std::uint32_t key;
+            bool          down;
+            float         held;
+        };
+
+        void Build();
+
+        [[nodiscard]] bool IsModified(const CompiledStep& a_step) const noexcept;
+
+        [[nodiscard]] bool Match(Binding& a_binding, std::uint32_t a_step, const Event& a_event,
+            Clock::time_point a_now);
+
+        Timing _timing;
+
+        std::vector<CompiledStep>  _steps;
+        std::vector<std::uint32_t> _modifiers;
+        std::vector<Binding>       _bindings;
+
+        // Watchers of each key, in descending order of step, so that a
+        // sequence in progress is continued in preference to restarted.
+        std::vector<std::uint32_t> _watchOffsets;
+        std::vector<Watch>         _watches;
+        bool                       _dirty{ true };
+
+        std::bitset<keyCount>    _pressed;
+        std::vector<Event>       _events;
+        std::vector<std::size_t> _fired;
+        std::uint64_t            _eventCount{ 0 };
+    };
+}
@@ -2,7 +2,62 @@
 
 namespace CLib
 {
-    [[nodiscard]] inline std::uint32_t ParseKey(std::uint32_t a_key, RE::INPUT_DEVICE a_device)
+    namespace Internal
+    {
+        /// Gamepad buttons with single-bit masks, in the order of their
+        /// keycodes. Keycodes of triggers follow them.
+        constexpr inline std::array kGamepadButtons{
+            RE::BSWin32GamepadDevice::Key::kUp,
+            RE::BSWin32GamepadDevice::Key::kDown,
+            RE::BSWin32GamepadDevice::Key::kLeft,
+            RE::BSWin32GamepadDevice::Key::kRight,
+            RE::BSWin32GamepadDevice::Key::kStart,
+            RE::BSWin32GamepadDevice::Key::kBack,
+            RE::BSWin32GamepadDevice::Key::kLeftThumb,
+            RE::BSWin32GamepadDevice::Key::kRightThumb,
+            RE::BSWin32GamepadDevice::Key::kLeftShoulder,
+            RE::BSWin32GamepadDevice::Key::kRightShoulder,
+            RE::BSWin32GamepadDevice::Key::kA,
+            RE::BSWin32GamepadDevice::Key::kB,
+            RE::BSWin32GamepadDevice::Key::kX,
+            RE::BSWin32GamepadDevice::Key::kY,
+        };
+
+        constexpr inline std::uint32_t kLeftTriggerKeycode = SKSE::InputMap::kMacro_GamepadOffset +
+                                                             static_cast<std::uint32_t>(kGamepadButtons.size());
+
+        /// Keycodes of single-bit gamepad button masks, by bit index.
+        constexpr inline auto kGamepadKeycodes = [] {
+            std::array<std::uint32_t, 32> table{};
+            table.fill(SKSE::InputMap::kMaxMacros);
+            for (std::uint32_t i = 0; i < kGamepadButtons.size(); ++i) {
+                auto mask = static_cast<std::uint32_t>(kGamepadButtons[i]);
+                table[std::countr_zero(mask)] = SKSE::InputMap::kMacro_GamepadOffset + i;
+            }
+            return table;
+        }();
+    }
+
+    /// Same as SKSE::InputMap::GamepadMaskToKeycode, by table lookup.
+    [[nodiscard]] constexpr std::uint32_t GamepadMaskToKeycode(std::uint32_t a_mask) noexcept
+    {
+        if (std::has_single_bit(a_mask)) {
+            return Internal::kGamepadKeycodes[std::countr_zero(a_mask)];
+        }
+        // Triggers are not bit masks.
+        switch (static_cast<RE::BSWin32GamepadDevice::Key>(a_mask)) {
+        case RE::BSWin32GamepadDevice::Key::kLeftTrigger:
+            return Internal::kLeftTriggerKeycode;
+        case RE::BSWin32GamepadDevice::Key::kRightTrigger:
+            return Internal::kLeftTriggerKeycode + 1;
+        default:
+            return SKSE::InputMap::kMaxMacros;
+        }
+    }
+
+    /// Map button of device to keycode of a single space, where keyboard,
+    /// mouse and gamepad come in turn.
+    [[nodiscard]] constexpr std::uint32_t ParseKey(std::uint32_t a_key, RE::INPUT_DEVICE a_device) noexcept
     {
         switch (a_device) {
         case RE::INPUT_DEVICE::kKeyboard:
@@ -10,114 +65,11 @@ namespace CLib
         case RE::INPUT_DEVICE::kMouse:
             return a_key + SKSE::InputMap::kMacro_MouseButtonOffset;
         case RE::INPUT_DEVICE::kGamepad:
-            return SKSE::InputMap::GamepadMaskToKeycode(a_key);
+            return GamepadMaskToKeycode(a_key);
         default:
             return a_key;
         }
     }
 
     constexpr inline std::uint32_t INVALID_KEY = 0;
-
-    namespace Internal
-    {
-        template <std::same_as<std::uint32_t>... T>
-        [[nodiscard]] inline std::uint16_t ResolveModifierKeyCount(std::uint32_t a_key, T... a_keys)
-        {
-            if constexpr (sizeof...(T) == 0) {
-                return a_key == INVALID_KEY ? 0 : 1;
-            } else {
-                return ResolveModifierKeyCount(a_key) + ResolveModifierKeyCount(a_keys...);
-            }
-        }
-    }
-
-    template <std::same_as<std::uint32_t>... T>
-    [[nodiscard]] inline std::uint16_t ResolveKeyCount(std::uint32_t a_key, T... a_keys)
-    {
-        if constexpr (sizeof...(T) == 0) {
-            return a_key == INVALID_KEY ? 0 : 1;
-        } else {
-            return a_key == INVALID_KEY ? 0 : 1 + Internal::ResolveModifierKeyCount(a_keys...);
-        }
-    }
-
-    class Key
-    {
-    public:
-        Key() = default;
-
-        explicit Key(std::uint32_t a_targetHotkey) noexcept : _targetHotkey(a_targetHotkey) {}
-
-        void Load(std::uint32_t a_targetHotkey) noexcept { _targetHotkey = a_targetHotkey; }
-
-        [[nodiscard]] bool IsActive() const noexcept { return _hasHotkey; }
-
-        void Reset() noexcept { _hasHotkey = false; }
-
-        void Update(std::uint32_t a_key) noexcept
-        {
-            if (_targetHotkey != INVALID_KEY && a_key == _targetHotkey) {
-                _hasHotkey = true;
-            }
-        }
-
-    private:
-        std::uint32_t _targetHotkey{ INVALID_KEY };
-
-        bool _hasHotkey{ false };
-    };
-
-    class KeyCombo
-    {
-    public:
-        KeyCombo() = default;
-
-        KeyCombo(std::uint32_t a_targetHotkey, std::uint32_t a_targetModifier) noexcept :
-            _targetHotkey(a_targetHotkey), _targetModifier(a_targetModifier),
-            _count(ResolveKeyCount(a_targetHotkey, a_targetModifier))
-        {}
-
-        [[nodiscard]] std::uint16_t Count() const noexcept { return _count; }
-
-        void Load(std::uint32_t a_targetHotkey, std::uint32_t a_targetModifier) noexcept
-        {
-            _targetHotkey = a_targetHotkey;
-            _targetModifier = a_targetModifier;
-            _count = ResolveKeyCount(a_targetHotkey, a_targetModifier);
-        }
-
-        [[nodiscard]] bool IsActive() const noexcept
-        {
-            return _hasHotkey && (_targetModifier == INVALID_KEY || _hasModifier);
-        }
-
-        void Reset() noexcept
-        {
-            _hasHotkey = false;
-            _hasModifier = false;
-        }
-
-        void UpdateDown(std::uint32_t a_key) noexcept
-        {
-            if (_targetHotkey != INVALID_KEY && a_key == _targetHotkey) {
-                _hasHotkey = true;
-            }
-        }
-
-        void UpdatePressed(std::uint32_t a_key) noexcept
-        {
-            if (_targetModifier != INVALID_KEY && a_key == _targetModifier) {
-                _hasModifier = true;
-            }
-        }
-
-    private:
-        std::uint32_t _targetHotkey{ INVALID_KEY };
-        std::uint32_t _targetModifier{ INVALID_KEY };
-
-        bool _hasHotkey{ false };
-        bool _hasModifier{ false };
-
-        std::uint16_t _count{ 0 };
-    };
 }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Growable byte buffer without upper bound.
+///
+/// Bytes live in fixed-size chunks, so appending never relocates or
+/// zero-fills previous bytes.
+class ChunkedBuffer
+{
+public:
+    static constexpr std::size_t chunk_size = 0x10000;
+
+    void append(const char* a_data, std::size_t a_size)
+    {
+        while (a_size > 0) {
+            auto offset = _size % chunk_size;
+            if (offset == 0 && _size / chunk_size == _chunks.size()) {
+                _chunks.push_back(std::make_unique_for_overwrite<char[]>(chunk_size));
+            }
+
+            auto count = std::min(a_size, chunk_size - offset);
+            std::memcpy(_chunks[_size / chunk_size].get() + offset, a_data, count);
+            _size += count;
+            a_data += count;
+            a_size -= count;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return _size; }
+
+    /// Copy out as a contiguous string.
+    [[nodiscard]] std::string str() const
+    {
+        std::string result;
+        result.resize_and_overwrite(_size, [this](char* a_data, std::size_t a_size) {
+            for (std::size_t i = 0; i < a_size; i += chunk_size) {
+                std::memcpy(a_data + i, _chunks[i / chunk_size].get(), std::min(chunk_size, a_size - i));
+            }
+            return a_size;
+        });
+        return result;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    std::size_t                          _size{ 0 };
+};
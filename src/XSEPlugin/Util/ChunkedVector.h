@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+/// Append-only vector with stable element addresses.
+///
+/// Elements live in fixed-size chunks, so growth never relocates existing
+/// elements, and readers may access elements published to them without
+/// locking. Appending must be serialized by caller.
+template <class T, std::uint32_t ChunkSize, std::uint32_t MaxChunks>
+    requires(std::has_single_bit(ChunkSize))
+class ChunkedVector
+{
+public:
+    using size_type = std::uint32_t;
+
+    static constexpr size_type chunk_size = ChunkSize;
+    static constexpr size_type max_size = ChunkSize * MaxChunks;
+
+    ChunkedVector() = default;
+
+    ChunkedVector(const ChunkedVector&) = delete;
+    ChunkedVector(ChunkedVector&&) = delete;
+    ChunkedVector& operator=(const ChunkedVector&) = delete;
+    ChunkedVector& operator=(ChunkedVector&&) = delete;
+
+    [[nodiscard]] T& operator[](size_type a_index) noexcept
+    {
+        return _chunks[a_index / ChunkSize][a_index % ChunkSize];
+    }
+
+    [[nodiscard]] const T& operator[](size_type a_index) const noexcept
+    {
+        return _chunks[a_index / ChunkSize][a_index % ChunkSize];
+    }
+
+    /// The number of elements. Only meaningful to writer.
+    [[nodiscard]] size_type size() const noexcept { return _size; }
+
+    /// Append default-initialized elements, which may straddle chunks.
+    ///
+    /// @return
+    ///   The index of the first appended element.
+    size_type grow(size_type a_count)
+    {
+        auto first = _size;
+        Reserve(first, a_count);
+        _size = first + a_count;
+        return first;
+    }
+
+    /// Append default-initialized elements within a single chunk, so that
+    /// they can be accessed as a contiguous range.
+    ///
+    /// @return
+    ///   The index of the first appended element.
+    size_type grow_contiguous(size_type a_count)
+    {
+        if (a_count > ChunkSize) {
+            throw std::length_error("ChunkedVector: contiguous range exceeds chunk size");
+        }
+
+        auto first = _size;
+        if (first % ChunkSize + a_count > ChunkSize) {
+            // Skip the tail of current chunk.
+            first = (first / ChunkSize + 1) * ChunkSize;
+        }
+        Reserve(first, a_count);
+        _size = first + a_count;
+        return first;
+    }
+
+private:
+    void Reserve(size_type a_first, size_type a_count)
+    {
+        if (a_count > max_size - a_first) {
+            throw std::length_error("ChunkedVector: too many elements");
+        }
+
+        auto last = a_first + a_count;
+        for (auto i = a_first / ChunkSize; i * ChunkSize < last; ++i) {
+            if (!_chunks[i]) {
+                _chunks[i] = std::make_unique_for_overwrite<T[]>(ChunkSize);
+            }
+        }
+    }
+
+    std::array<std::unique_ptr<T[]>, MaxChunks> _chunks;
+    size_type                                   _size{ 0 };
+};
@@ -0,0 +1,172 @@
+#include "SearchIndex.h"
+
+namespace
+{
+    [[nodiscard]] std::string Fold(std::string_view a_str)
+    {
+        std::string result{ a_str };
+        for (auto& c : result) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] inline std::uint32_t MakeTrigram(const char* a_str) noexcept
+    {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(a_str[0])) |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(a_str[1])) << 8 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(a_str[2])) << 16;
+    }
+
+    [[nodiscard]] inline bool IsBoundary(std::string_view a_str, std::size_t a_pos) noexcept
+    {
+        if (a_pos == 0) {
+            return true;
+        }
+        switch (a_str[a_pos - 1]) {
+        case ' ':
+        case '_':
+        case '-':
+        case '.':
+        case '/':
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+SearchIndex::DocID SearchIndex::Add(std::string_view a_text)
+{
+    auto id = static_cast<DocID>(_docs.size());
+    _docs.push_back({ std::string{ a_text }, Fold(a_text), true });
+    Post(id);
+    return id;
+}
+
+void SearchIndex::Remove(DocID a_id)
+{
+    auto& doc = _docs[a_id];
+    if (!doc.alive) {
+        return;
+    }
+    doc.alive = false;
+    doc.text = {};
+    doc.folded = {};
+    ++_removed;
+    ++_stale;
+
+    // Removed IDs stay in posting lists until they outnumber live ones.
+    if (_stale > Size()) {
+        Compact();
+    }
+}
+
+std::vector<SearchIndex::Match> SearchIndex::Query(std::string_view a_query, std::size_t a_limit) const
+{
+    auto                     folded = Fold(a_query);
+    std::vector<std::string> terms;
+    for (auto term : std::views::split(folded, ' ')) {
+        if (!std::ranges::empty(term)) {
+            terms.emplace_back(std::ranges::begin(term), std::ranges::end(term));
+        }
+    }
+    if (terms.empty() || a_limit == 0) {
+        return {};
+    }
+
+    auto isMatch = [&](const Doc& a_doc) {
+        return a_doc.alive && std::ranges::all_of(terms, [&](const std::string& a_term) {
+            return a_doc.folded.find(a_term) != std::string::npos;
+        });
+    };
+
+    std::vector<Match> matches;
+
+    // Posting lists of all trigrams of long terms.
+    std::vector<const std::vector<DocID>*> lists;
+    for (const auto& term : terms) {
+        for (std::size_t i = 0; i + 3 <= term.size(); ++i) {
+            auto it = _postings.find(MakeTrigram(term.data() + i));
+            if (it == _postings.end()) {
+                return {};
+            }
+            lists.push_back(std::addressof(it->second));
+        }
+    }
+
+    if (!lists.empty()) {
+        // Intersect starting from the shortest list.
+        std::ranges::sort(lists, {}, [](const auto* a_list) { return a_list->size(); });
+        auto others = std::span{ lists }.subspan(1);
+        for (auto id : *lists.front()) {
+            auto inAll = std::ranges::all_of(others, [id](const auto* a_list) {
+                return std::ranges::binary_search(*a_list, id);
+            });
+            if (inAll && isMatch(_docs[id])) {
+                matches.push_back({ id, Score(_docs[id], terms) });
+            }
+        }
+    } else {
+        // Rank every match, not the first ones by ID.
+        for (DocID id = 0; id < _docs.size(); ++id) {
+            if (isMatch(_docs[id])) {
+                matches.push_back({ id, Score(_docs[id], terms) });
+            }
+        }
+    }
+
+    auto count = std::min(a_limit, matches.size());
+    std::ranges::partial_sort(matches, matches.begin() + count, [](const Match& a_lhs, const Match& a_rhs) {
+        return a_lhs.score != a_rhs.score ? a_lhs.score > a_rhs.score : a_lhs.id < a_rhs.id;
+    });
+    matches.resize(count);
+    return matches;
+}
+
+void SearchIndex::Compact()
+{
+    _postings.clear();
+    for (DocID id = 0; id < _docs.size(); ++id) {
+        if (_docs[id].alive) {
+            Post(id);
+        }
+    }
+    _stale = 0;
+}
+
+void SearchIndex::Post(DocID a_id)
+{
+    const auto& folded = _docs[a_id].folded;
+    for (std::size_t i = 0; i + 3 <= folded.size(); ++i) {
+        auto& list = _postings[MakeTrigram(folded.data() + i)];
+        // A trigram may occur more than once.
+        if (list.empty() || list.back() != a_id) {
+            list.push_back(a_id);
+        }
+    }
+}
+
+std::int32_t SearchIndex::Score(const Doc& a_doc, const std::vector<std::string>& a_terms) const
+{
+    std::string_view folded{ a_doc.folded };
+    auto             nameOffset = folded.rfind('/') + 1;  // 0 if not found.
+    auto             name = folded.substr(nameOffset);
+
+    std::int32_t score = 0;
+    for (const auto& term : a_terms) {
+        if (auto pos = name.find(term); pos != std::string_view::npos) {
+            score += 100;
+            if (IsBoundary(name, pos)) {
+                score += 50;
+            }
+        } else {
+            score += IsBoundary(folded, folded.find(term)) ? 20 : 10;
+        }
+    }
+    // Prefer shallow and short paths.
+    score -= static_cast<std::int32_t>(std::ranges::count(folded, '/') * 8 + folded.size() / 4);
+    return score;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// A trigram index for case-insensitive substring search over short texts,
+/// such as paths.
+///
+/// Query is split into whitespace-separated terms, and a text matches if it
+/// contains all of them. Terms of at least three bytes are looked up in
+/// posting lists; shorter terms only filter candidates, or fall back to a
+/// scan of every text if the query has no longer term.
+///
+/// @note
+///   Not thread-safe.
+class SearchIndex
+{
+public:
+    using DocID = std::uint32_t;
+
+    struct Match
+    {
+        DocID        id;
+        std::int32_t score;  // Higher is better.
+    };
+
+    /// Add a text, whose last component after '/' is ranked higher.
+    DocID Add(std::string_view a_text);
+
+    void Remove(DocID a_id);
+
+    /// Find texts containing all terms of query, ranked by score.
+    [[nodiscard]] std::vector<Match> Query(std::string_view a_query, std::size_t a_limit) const;
+
+    [[nodiscard]] std::string_view Text(DocID a_id) const noexcept { return _docs[a_id].text; }
+
+    [[nodiscard]] std::size_t Size() const noexcept { return _docs.size() - _removed; }
+
+private:
+    struct Doc
+    {
+        std::string text;
+        std::string folded;  // ASCII lowercase of text.
+        bool        alive;
+    };
+
+    using Trigram = std::uint32_t;
+
+    /// Rebuild posting lists without removed documents.
+    void Compact();
+
+    void Post(DocID a_id);
+
+    [[nodiscard]] std::int32_t Score(const Doc& a_doc, const std::vector<std::string>& a_terms) const;
+
+    std::vector<Doc>                                 _docs;
+    std::unordered_map<Trigram, std::vector<DocID>> _postings;  // Sorted by ID.
+    std::size_t                                      _removed{ 0 };
+    std::size_t                                      _stale{ 0 };  // Removed but still posted.
+};
@@ -3,8 +3,6 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
-#include <mutex>
-#include <shared_mutex>
 
 template <class T>
 class Singleton
@@ -26,23 +24,34 @@ protected:
     ~Singleton() = default;
 };
 
+/// A singleton published as immutable snapshots.
+///
+/// Readers take the current snapshot with a single atomic load. It is not
+/// lock-free on MSVC, where the load takes a short internal lock that only
+/// spans copying the pointer, so readers never wait for a writer to build a
+/// snapshot. Writers build a new instance aside and publish it as a whole,
+/// so that readers holding the old snapshot keep a consistent view until
+/// they release it.
+///
+/// Each singleton is published on its own. Readers of two singletons may see
+/// the new snapshot of one along with the old snapshot of the other.
 template <class T>
 class SingletonEx
 {
 public:
-    [[nodiscard]] static T* GetSingleton() noexcept { return _singleton.get(); }
-
-    [[nodiscard]] static std::shared_mutex& Mutex() noexcept { return _mutex; }
+    /// The current snapshot. Hold it rather than calling again, so that all
+    /// values read come from the same snapshot.
+    [[nodiscard]] static std::shared_ptr<const T> GetSingleton() noexcept { return _singleton.load(); }
 
     [[nodiscard]] static bool IsVersionChanged(std::uint32_t a_version) noexcept
     {
         return _version.load() != a_version;
     }
 
+    /// The version of current snapshot. Read it before taking snapshot, so
+    /// that a snapshot published in between is picked up next time.
     [[nodiscard]] static std::uint32_t Version() noexcept { return _version.load(); }
 
-    static void IncrementVersion() noexcept { _version.fetch_add(1); }
-
     SingletonEx(const SingletonEx&) = delete;
     SingletonEx(SingletonEx&&) = delete;
     SingletonEx& operator=(const SingletonEx&) = delete;
@@ -54,10 +63,19 @@ protected:
 
     struct Deleter
     {
-        void operator()(T* a_ptr) const { delete a_ptr; }
+        void operator()(const T* a_ptr) const { delete a_ptr; }
     };
 
-    static inline std::unique_ptr<T, Deleter> _singleton;
-    static inline std::shared_mutex           _mutex;
-    static inline std::atomic<std::uint32_t>  _version{ 0 };
+    /// Make an empty instance to build a snapshot from.
+    [[nodiscard]] static std::shared_ptr<T> Make() { return std::shared_ptr<T>{ new T, Deleter{} }; }
+
+    /// Replace current snapshot, then increase version.
+    static void Publish(std::shared_ptr<const T> a_snapshot) noexcept
+    {
+        _singleton.store(std::move(a_snapshot));
+        _version.fetch_add(1);
+    }
+
+    static inline std::atomic<std::shared_ptr<const T>> _singleton;
+    static inline std::atomic<std::uint32_t>            _version{ 0 };
 };
@@ -0,0 +1,175 @@
+#include "ThreadPool.h"
+
+namespace
+{
+    // The pool and worker index of calling thread, if it is a worker.
+    thread_local const ThreadPool* tl_pool{ nullptr };
+    thread_local std::uint32_t     tl_index{ 0 };
+}
+
+ThreadPool::ThreadPool(std::uint32_t a_threadCount)
+{
+    a_threadCount = std::max(a_threadCount, 1u);
+
+    _workers.reserve(a_threadCount);
+    for (std::uint32_t i = 0; i < a_threadCount; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+
+    _threads.reserve(a_threadCount);
+    for (std::uint32_t i = 0; i < a_threadCount; ++i) {
+        _threads.emplace_back([this, i]() { Run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock{ _sleepMutex };
+        _stop = true;
+    }
+    _sleepCond.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::Submit(Task a_task) { Submit(nullptr, std::move(a_task)); }
+
+void ThreadPool::Submit(const TaskGroup* a_group, Task a_task)
+{
+    auto index = (tl_pool == this) ? tl_index : _next.fetch_add(1, std::memory_order_relaxed) % ThreadCount();
+    {
+        auto&            worker = *_workers[index];
+        std::scoped_lock lock{ worker.mutex };
+        worker.tasks.push_back({ a_group, std::move(a_task) });
+    }
+
+    {
+        // Publish under lock, so that a worker about to sleep does not miss it.
+        std::scoped_lock lock{ _sleepMutex };
+        _queued.fetch_add(1);
+    }
+    _sleepCond.notify_one();
+}
+
+bool ThreadPool::RunOne(const TaskGroup* a_group)
+{
+    Task task;
+    if (!TryPop(a_group, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::Run(std::uint32_t a_index)
+{
+    tl_pool = this;
+    tl_index = a_index;
+
+    for (;;) {
+        Task task;
+        if (TryPop(a_index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock lock{ _sleepMutex };
+        _sleepCond.wait(lock, [this]() { return _stop || _queued.load() > 0; });
+        if (_stop) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::TryPop(std::uint32_t a_index, Task& a_task)
+{
+    auto count = ThreadCount();
+    for (std::uint32_t i = 0; i < count; ++i) {
+        auto&            worker = *_workers[(a_index + i) % count];
+        std::scoped_lock lock{ worker.mutex };
+        if (worker.tasks.empty()) {
+            continue;
+        }
+
+        if (i == 0) {
+            a_task = std::move(worker.tasks.back().task);
+            worker.tasks.pop_back();
+        } else {
+            a_task = std::move(worker.tasks.front().task);
+            worker.tasks.pop_front();
+        }
+        _queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::TryPop(const TaskGroup* a_group, Task& a_task)
+{
+    auto start = (tl_pool == this) ? tl_index : 0;
+    auto count = ThreadCount();
+    for (std::uint32_t i = 0; i < count; ++i) {
+        auto&            worker = *_workers[(start + i) % count];
+        std::scoped_lock lock{ worker.mutex };
+        // Newest first, as subtasks are pushed after their parent.
+        auto it = std::ranges::find(worker.tasks.rbegin(), worker.tasks.rend(), a_group, &Entry::group);
+        if (it == worker.tasks.rend()) {
+            continue;
+        }
+
+        a_task = std::move(it->task);
+        worker.tasks.erase(std::next(it).base());
+        _queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void TaskGroup::Run(std::move_only_function<void()> a_task)
+{
+    _pending.fetch_add(1);
+    _pool.Submit(this, [this, task = std::move(a_task)]() mutable {
+        try {
+            task();
+            Done(nullptr);
+        } catch (...) {
+            Done(std::current_exception());
+        }
+    });
+}
+
+void TaskGroup::Wait()
+{
+    Wait(std::nothrow);
+
+    std::scoped_lock lock{ _mutex };
+    if (auto error = std::exchange(_error, nullptr)) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::Wait(std::nothrow_t) noexcept
+{
+    // Help rather than block, tasks of this group may be queued behind others.
+    // Only tasks of this group, so that a task taking a lock held by caller
+    // does not run on this thread.
+    while (_pending.load() > 0 && _pool.RunOne(this)) {}
+
+    // Synchronize with the last Done(), which notifies under lock.
+    std::unique_lock lock{ _mutex };
+    _cond.wait(lock, [this]() { return _pending.load() == 0; });
+}
+
+void TaskGroup::Done(std::exception_ptr a_error) noexcept
+{
+    std::scoped_lock lock{ _mutex };
+    if (a_error && !_error) {
+        _error = std::move(a_error);
+    }
+    if (_pending.fetch_sub(1) == 1) {
+        _cond.notify_all();
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+/// A fixed-size work-stealing thread pool.
+///
+/// Each worker owns a deque. A worker pushes and pops tasks at the back of
+/// its own deque, and steals from the front of others when it runs out, so
+/// a task that fans out keeps its subtasks local until others are idle.
+class ThreadPool
+{
+public:
+    using Task = std::move_only_function<void()>;
+
+    explicit ThreadPool(std::uint32_t a_threadCount);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /// Queue task to the deque of calling worker, or distribute it round-robin
+    /// if called from outside the pool.
+    void Submit(Task a_task);
+
+    /// Run one queued task of the given group on calling thread. Tasks of
+    /// other groups are never run, as caller may hold locks they take.
+    ///
+    /// @return
+    ///   False if there is no queued task of the group.
+    bool RunOne(const TaskGroup* a_group);
+
+    [[nodiscard]] std::uint32_t ThreadCount() const noexcept { return static_cast<std::uint32_t>(_threads.size()); }
+
+private:
+    friend class TaskGroup;
+
+    struct Entry
+    {
+        const TaskGroup* group;  // Or nullptr if submitted alone.
+        Task             task;
+    };
+
+    struct Worker
+    {
+        std::mutex        mutex;
+        std::deque<Entry> tasks;
+    };
+
+    void Submit(const TaskGroup* a_group, Task a_task);
+
+    void Run(std::uint32_t a_index);
+
+    /// Pop from the back of own deque, or steal from the front of others.
+    bool TryPop(std::uint32_t a_index, Task& a_task);
+
+    /// Pop a task of the given group, from any deque.
+    bool TryPop(const TaskGroup* a_group, Task& a_task);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread>             _threads;
+
+    std::mutex                 _sleepMutex;
+    std::condition_variable    _sleepCond;
+    std::atomic<std::uint32_t> _queued{ 0 };
+    std::atomic<std::uint32_t> _next{ 0 };
+    bool                       _stop{ false };
+};
+
+/// A group of tasks that can be waited on together.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& a_pool) noexcept : _pool(a_pool) {}
+
+    ~TaskGroup() { Wait(std::nothrow); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup(TaskGroup&&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    TaskGroup& operator=(TaskGroup&&) = delete;
+
+    /// Submit task to the pool. Tasks may run more tasks in the same group.
+    void Run(std::move_only_function<void()> a_task);
+
+    /// Wait until all tasks finish, running queued tasks of this group on
+    /// calling thread in the meantime. Rethrow the first exception thrown by
+    /// any task.
+    void Wait();
+
+private:
+    void Wait(std::nothrow_t) noexcept;
+
+    /// Mark a task as finished.
+    void Done(std::exception_ptr a_error) noexcept;
+
+    ThreadPool&                _pool;
+    std::atomic<std::uint32_t> _pending{ 0 };
+    std::mutex                 _mutex;
+    std::condition_variable    _cond;
+    std::exception_ptr         _error;
+};
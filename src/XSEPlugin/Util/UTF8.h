@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace UTF8
+{
+    /// Whether all bytes of string are below 0x80.
+    [[nodiscard]] inline bool IsASCII(std::string_view a_str) noexcept
+    {
+        auto        data = a_str.data();
+        std::size_t i = 0;
+#if defined(_M_X64) || defined(__SSE2__)
+        // The sign bit of each byte is set for non-ASCII.
+        for (; i + 16 <= a_str.size(); i += 16) {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            if (_mm_movemask_epi8(chunk) != 0) {
+                return false;
+            }
+        }
+#endif
+        for (; i < a_str.size(); ++i) {
+            if (static_cast<unsigned char>(data[i]) >= 0x80) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// The length of sequence led by the given byte. Invalid lead byte counts
+    /// as a sequence of its own.
+    [[nodiscard]] inline std::size_t SequenceLength(char a_lead) noexcept
+    {
+        auto c = static_cast<unsigned char>(a_lead);
+        if (c >= 0xF0) {
+            return 4;
+        }
+        if (c >= 0xE0) {
+            return 3;
+        }
+        if (c >= 0xC0) {
+            return 2;
+        }
+        return 1;
+    }
+
+    /// Append non-ASCII sequences of string to the given list.
+    inline void CollectNonASCII(std::string_view a_str, std::vector<std::string_view>& a_out)
+    {
+        if (IsASCII(a_str)) {
+            return;
+        }
+        for (std::size_t i = 0; i < a_str.size();) {
+            auto len = std::min(SequenceLength(a_str[i]), a_str.size() - i);
+            if (len > 1 || static_cast<unsigned char>(a_str[i]) >= 0x80) {
+                a_out.push_back(a_str.substr(i, len));
+            }
+            i += len;
+        }
+    }
+}
@@ -16,6 +16,57 @@ namespace Win
         }
     }
 
+    bool MappedFile::Open(const wchar_t* a_path) noexcept
+    {
+        Close();
+
+        HANDLE hFile = CreateFileW(a_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        _file = hFile;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0 ||
+            static_cast<std::uint64_t>(size.QuadPart) > SIZE_MAX) {
+            Close();
+            return false;
+        }
+
+        HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!hMapping) {
+            Close();
+            return false;
+        }
+        _mapping = hMapping;
+
+        _view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (!_view) {
+            Close();
+            return false;
+        }
+        _size = static_cast<std::size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (_view) {
+            UnmapViewOfFile(_view);
+            _view = nullptr;
+        }
+        if (_mapping) {
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+        }
+        if (_file) {
+            CloseHandle(_file);
+            _file = nullptr;
+        }
+        _size = 0;
+    }
+
     std::optional<OsVersion> OsVersion::Get() noexcept
     {
         using RtlGetVersionFuncPtr = NTSTATUS(WINAPI*)(PRTL_OSVERSIONINFOEXW);
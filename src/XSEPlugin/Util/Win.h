@@ -1,9 +1,11 @@
 #pragma once
 
 #include <compare>
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -22,6 +24,39 @@ namespace Win
         return reinterpret_cast<T>(Internal::GetModuleFunc(a_moduleName, a_funcName));
     }
 
+    /// A read-only memory mapping of a whole file.
+    class MappedFile
+    {
+    public:
+        MappedFile() noexcept = default;
+
+        ~MappedFile() { Close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        /// Map file, closing previous mapping if any.
+        ///
+        /// @return
+        ///   False if file does not exist, is empty, or cannot be mapped.
+        [[nodiscard]] bool Open(const wchar_t* a_path) noexcept;
+
+        void Close() noexcept;
+
+        [[nodiscard]] std::span<const std::byte> data() const noexcept
+        {
+            return { static_cast<const std::byte*>(_view), _size };
+        }
+
+    private:
+        void*       _file{ nullptr };
+        void*       _mapping{ nullptr };
+        const void* _view{ nullptr };
+        std::size_t _size{ 0 };
+    };
+
     /// The version of Windows operating system.
     class OsVersion
     {